@@ -18,3 +18,55 @@ const GxEPD2::ScreenDimensionType GxEPD2::ScreenDimensions[]
   {640, 384}  // GDEW075Z09
 };
 
+
+void GxEPD2::initSPI()
+{
+  static bool spi_initialized = false;
+  if (spi_initialized) return;
+  spi_initialized = true;
+  SPI.begin();
+  SPI.setDataMode(SPI_MODE0);
+  SPI.setBitOrder(MSBFIRST);
+#if defined(SPI_HAS_TRANSACTION)
+  // true also for STM32F1xx Boards
+  SPISettings settings(4000000, MSBFIRST, SPI_MODE0);
+  SPI.beginTransaction(settings);
+  SPI.endTransaction();
+  //Serial.println("SPI has Transaction");
+#elif defined(ESP8266) || defined(ESP32)
+  SPI.setFrequency(4000000);
+#endif
+}
+
+uint8_t GxEPD2::addWindow(Window windows[], uint8_t count, uint8_t max_count, uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+  uint8_t i = 0;
+  for (; i < count; i++)
+  {
+    Window& pw = windows[i];
+    bool overlaps = (x < pw.x + pw.w) && (pw.x < x + w) && (y < pw.y + pw.h) && (pw.y < y + h);
+    if (overlaps || (i == max_count - 1)) break;
+  }
+  if (i == count)
+  {
+    windows[count++] = Window{x, y, w, h};
+    return count;
+  }
+  Window& pw = windows[i];
+  uint16_t xe = (x + w > pw.x + pw.w) ? x + w : pw.x + pw.w;
+  uint16_t ye = (y + h > pw.y + pw.h) ? y + h : pw.y + pw.h;
+  pw.x = (x < pw.x) ? x : pw.x;
+  pw.y = (y < pw.y) ? y : pw.y;
+  pw.w = xe - pw.x;
+  pw.h = ye - pw.y;
+  return count;
+}
+
+uint16_t GxEPD2::lutFrameScale(int8_t celsius)
+{
+  // the LUTs are tuned for room temperature, the particles move slower in the cold
+  if (celsius >= 15) return 100;
+  if (celsius >= 5) return 150;
+  if (celsius >= 0) return 200;
+  return 300;
+}
@@ -11,6 +11,53 @@
 #define GxEPD_WHITE     0xFFFF
 #define GxEPD_RED       0xF800      /* 255,   0,   0 */
 
+// uncomment to collect transfer and timing statistics per display instance, see statistics()
+//#define GxEPD2_STATISTICS
+
+// uncomment to record the command stream in a ring buffer per display instance, see trace()
+//#define GxEPD2_TRACE
+
+// uncomment to send pages from a second core (ESP32) or thread (host builds) while the next page is drawn,
+// GxEPD2_32_BW only; the page buffer is split in two halves, so there are twice as many pages
+//#define GxEPD2_PIPELINE
+
+// uncomment to let display instances borrow a shared page buffer instead of embedding their own, see setArena()
+//#define GxEPD2_BUFFER_ARENA
+
+// uncomment to interleave the black and red bytes of the GxEPD2_32_3C page buffer, for faster drawing
+//#define GxEPD2_3C_INTERLEAVED
+
+// uncomment to keep a copy of the GDEW042T2 screen (15'000 bytes) in GxEPD2_32_BW, to keep the old data RAM in sync;
+// a partial update then sends the changed bytes only, and refreshes once, without the second phase
+//#define GxEPD2_SHADOW
+
+#if defined(GxEPD2_STATISTICS)
+#define GxEPD2_STAT(statement) statement
+#else
+#define GxEPD2_STAT(statement)
+#endif
+
+#if defined(GxEPD2_TRACE)
+#define GxEPD2_TRC(statement) statement
+#include "GxEPD2_32_Trace.h"
+#else
+#define GxEPD2_TRC(statement)
+#endif
+
+#if defined(GxEPD2_PIPELINE)
+#include "GxEPD2_32_Pipeline.h"
+#endif
+
+#if defined(GxEPD2_BUFFER_ARENA)
+#include "GxEPD2_32_Arena.h"
+#endif
+
+#if defined(GxEPD2_STATISTICS) || defined(GxEPD2_TRACE)
+#define GxEPD2_TIME(statement) statement
+#else
+#define GxEPD2_TIME(statement)
+#endif
+
 class GxEPD2
 {
   public:
@@ -36,6 +83,53 @@ class GxEPD2
       uint16_t height;
     };
     static const ScreenDimensionType ScreenDimensions[];
+    // partial window or dirty region
+    struct Window
+    {
+      uint16_t x, y, w, h;
+    };
+    // adds a window to the count windows: merged with an overlapping one, or into the last one if max_count are used;
+    // returns the new count
+    static uint8_t addWindow(Window windows[], uint8_t count, uint8_t max_count, uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+    // SPI.begin() and settings, done once for all panels on the bus
+    static void initSPI();
+    // frame count scale in percent for register LUTs, by ambient temperature
+    static uint16_t lutFrameScale(int8_t celsius);
+    enum BusyPhase
+    {
+      BusyPowerOn, BusyUpdateFull, BusyUpdatePart, BusyPowerOff, BusyOther, BusyPhases
+    };
+    // waveforms by update type; LutFast and LutClean are custom waveforms, see GxEPD2_32_BW::setWaveform()
+    enum LutMode
+    {
+      LutNone, LutFull, LutPartial, LutFast, LutClean, LutGrey, LutModes
+    };
+    // one LUT register write of a waveform: command and its data
+    struct LutTable
+    {
+      uint8_t command;
+      const uint8_t* data;
+      uint8_t size;
+    };
+    // driver state to keep over deep sleep, e.g. in ESP32 RTC_DATA_ATTR memory, see saveState()
+    struct RetainedState
+    {
+      uint32_t magic; // set by saveState()
+      uint8_t panel, flags, lut_mode;
+      uint16_t lut_scale; // of the loaded LUT, see setTemperature()
+      uint8_t partial_updates[16]; // GxEPD2_32_BW partial update counts per screen tile
+    };
+    static const uint32_t RetainedStateMagic = 0x47583333; // "GX33", changes with the layout
+    static const uint8_t RetainedInitial = 0x01, RetainedPowerIsOn = 0x02;
+    struct Statistics
+    {
+      uint32_t command_bytes, data_bytes, cs_toggles;
+      uint32_t spi_us;    // time in SPI transfers
+      uint32_t render_us; // time drawing pages, between firstPage()/nextPage() calls
+      uint32_t init_us;   // time in controller init and LUT upload
+      uint32_t busy_us[BusyPhases]; // time waiting on BUSY, per phase
+      uint32_t pages;
+    };
 };
 #endif
 
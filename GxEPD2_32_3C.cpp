@@ -17,25 +17,71 @@
 // this workaround for GDEW042Z15 updates the whole screen
 #define USE_PARTIAL_UPDATE_WORKAROUND_ON_GDEW042Z15
 
-const uint8_t GxEPD2_32_3C::bw2grey[] =
+// b/w byte to 2 bit grey for GDEW0154Z04, each pixel doubled, high byte first
+const uint16_t GxEPD2_32_3C::bw2grey[] =
 {
-  0b00000000, 0b00000011, 0b00001100, 0b00001111,
-  0b00110000, 0b00110011, 0b00111100, 0b00111111,
-  0b11000000, 0b11000011, 0b11001100, 0b11001111,
-  0b11110000, 0b11110011, 0b11111100, 0b11111111,
+  0x0000, 0x0003, 0x000C, 0x000F, 0x0030, 0x0033, 0x003C, 0x003F,
+  0x00C0, 0x00C3, 0x00CC, 0x00CF, 0x00F0, 0x00F3, 0x00FC, 0x00FF,
+  0x0300, 0x0303, 0x030C, 0x030F, 0x0330, 0x0333, 0x033C, 0x033F,
+  0x03C0, 0x03C3, 0x03CC, 0x03CF, 0x03F0, 0x03F3, 0x03FC, 0x03FF,
+  0x0C00, 0x0C03, 0x0C0C, 0x0C0F, 0x0C30, 0x0C33, 0x0C3C, 0x0C3F,
+  0x0CC0, 0x0CC3, 0x0CCC, 0x0CCF, 0x0CF0, 0x0CF3, 0x0CFC, 0x0CFF,
+  0x0F00, 0x0F03, 0x0F0C, 0x0F0F, 0x0F30, 0x0F33, 0x0F3C, 0x0F3F,
+  0x0FC0, 0x0FC3, 0x0FCC, 0x0FCF, 0x0FF0, 0x0FF3, 0x0FFC, 0x0FFF,
+  0x3000, 0x3003, 0x300C, 0x300F, 0x3030, 0x3033, 0x303C, 0x303F,
+  0x30C0, 0x30C3, 0x30CC, 0x30CF, 0x30F0, 0x30F3, 0x30FC, 0x30FF,
+  0x3300, 0x3303, 0x330C, 0x330F, 0x3330, 0x3333, 0x333C, 0x333F,
+  0x33C0, 0x33C3, 0x33CC, 0x33CF, 0x33F0, 0x33F3, 0x33FC, 0x33FF,
+  0x3C00, 0x3C03, 0x3C0C, 0x3C0F, 0x3C30, 0x3C33, 0x3C3C, 0x3C3F,
+  0x3CC0, 0x3CC3, 0x3CCC, 0x3CCF, 0x3CF0, 0x3CF3, 0x3CFC, 0x3CFF,
+  0x3F00, 0x3F03, 0x3F0C, 0x3F0F, 0x3F30, 0x3F33, 0x3F3C, 0x3F3F,
+  0x3FC0, 0x3FC3, 0x3FCC, 0x3FCF, 0x3FF0, 0x3FF3, 0x3FFC, 0x3FFF,
+  0xC000, 0xC003, 0xC00C, 0xC00F, 0xC030, 0xC033, 0xC03C, 0xC03F,
+  0xC0C0, 0xC0C3, 0xC0CC, 0xC0CF, 0xC0F0, 0xC0F3, 0xC0FC, 0xC0FF,
+  0xC300, 0xC303, 0xC30C, 0xC30F, 0xC330, 0xC333, 0xC33C, 0xC33F,
+  0xC3C0, 0xC3C3, 0xC3CC, 0xC3CF, 0xC3F0, 0xC3F3, 0xC3FC, 0xC3FF,
+  0xCC00, 0xCC03, 0xCC0C, 0xCC0F, 0xCC30, 0xCC33, 0xCC3C, 0xCC3F,
+  0xCCC0, 0xCCC3, 0xCCCC, 0xCCCF, 0xCCF0, 0xCCF3, 0xCCFC, 0xCCFF,
+  0xCF00, 0xCF03, 0xCF0C, 0xCF0F, 0xCF30, 0xCF33, 0xCF3C, 0xCF3F,
+  0xCFC0, 0xCFC3, 0xCFCC, 0xCFCF, 0xCFF0, 0xCFF3, 0xCFFC, 0xCFFF,
+  0xF000, 0xF003, 0xF00C, 0xF00F, 0xF030, 0xF033, 0xF03C, 0xF03F,
+  0xF0C0, 0xF0C3, 0xF0CC, 0xF0CF, 0xF0F0, 0xF0F3, 0xF0FC, 0xF0FF,
+  0xF300, 0xF303, 0xF30C, 0xF30F, 0xF330, 0xF333, 0xF33C, 0xF33F,
+  0xF3C0, 0xF3C3, 0xF3CC, 0xF3CF, 0xF3F0, 0xF3F3, 0xF3FC, 0xF3FF,
+  0xFC00, 0xFC03, 0xFC0C, 0xFC0F, 0xFC30, 0xFC33, 0xFC3C, 0xFC3F,
+  0xFCC0, 0xFCC3, 0xFCCC, 0xFCCF, 0xFCF0, 0xFCF3, 0xFCFC, 0xFCFF,
+  0xFF00, 0xFF03, 0xFF0C, 0xFF0F, 0xFF30, 0xFF33, 0xFF3C, 0xFF3F,
+  0xFFC0, 0xFFC3, 0xFFCC, 0xFFCF, 0xFFF0, 0xFFF3, 0xFFFC, 0xFFFF,
+};
+
+// 2 black and 2 red bits to 2 GDEW075Z09 pixels, index black1 black0 red1 red0
+const uint8_t GxEPD2_32_3C::br2pixels[] =
+{
+  0x33, 0x34, 0x43, 0x44, 0x30, 0x30, 0x40, 0x40,
+  0x03, 0x04, 0x03, 0x04, 0x00, 0x00, 0x00, 0x00
 };
 
 GxEPD2_32_3C::GxEPD2_32_3C(GxEPD2::Panel panel, int8_t cs, int8_t dc, int8_t rst, int8_t busy) :
   Adafruit_GFX(GxEPD2::ScreenDimensions[panel].width, GxEPD2::ScreenDimensions[panel].height),
   _panel(panel), _cs(cs), _dc(dc), _rst(rst), _busy(busy),
-  _current_page(-1), _using_partial_mode(false), _mirror(false)
+  _current_page(-1), _using_partial_mode(false), _mirror(false), _image_active(false), _window_count(0), _window_index(0),
+  _busy_callback(0), _busy_callback_parameter(0),
+#if defined(GxEPD2_BUFFER_ARENA)
+  _arena(0),
+#endif
+  _black_buffer(0), _red_buffer(0), _buffer_size(buffer_size)
 {
   _initial = true;
   _power_is_on = false;
+  _lut_mode = GxEPD2::LutNone;
+  _lut_scale = 100;
   _width_bytes = uint16_t(WIDTH) / 8; // just discard any (WIDTH % 8) pixels
   _pixel_bytes = _width_bytes * uint16_t(HEIGHT); // save uint16_t range
-  _page_height = buffer_size / _width_bytes;
-  _pages = (HEIGHT / _page_height) + ((HEIGHT % _page_height) > 0);
+  _setPageArea(0, 0, WIDTH, HEIGHT);
+#if !defined(GxEPD2_BUFFER_ARENA)
+  _setBuffers(_buffer);
+#endif
+  resetStatistics();
   _busy_active_level = LOW;
 }
 
@@ -59,23 +105,22 @@ void GxEPD2_32_3C::drawPixel(int16_t x, int16_t y, uint16_t color)
       y = HEIGHT - y - 1;
       break;
   }
-  uint16_t i = x / 8 + y * _width_bytes;
-  if (_current_page < 1)
-  {
-    if (i >= sizeof(_black_buffer)) return;
-  }
-  else
-  {
-    y -= _current_page * _page_height;
-    if ((y < 0) || (y >= _page_height)) return;
-    i = x / 8 + y * _width_bytes;
-  }
-
-  _black_buffer[i] = (_black_buffer[i] & (0xFF ^ (1 << (7 - x % 8)))); // white
-  _red_buffer[i] = (_red_buffer[i] & (0xFF ^ (1 << (7 - x % 8)))); // white
-  if (color == GxEPD_WHITE) return;
-  else if (color == GxEPD_BLACK) _black_buffer[i] = (_black_buffer[i] | (1 << (7 - x % 8)));
-  else if (color == GxEPD_RED) _red_buffer[i] = (_red_buffer[i] | (1 << (7 - x % 8)));
+  // buffers cover the page area only, full screen or partial window
+  x -= _area_x;
+  y -= _area_y;
+  if ((x < 0) || (x >= _area_width_bytes * 8) || (y < 0) || (y >= _area_height)) return;
+  if (_current_page > 0) y -= _current_page * _page_height;
+  if ((y < 0) || (y >= _page_height)) return;
+  uint16_t i = x / 8 + y * _area_width_bytes;
+#if defined(GxEPD2_BUFFER_ARENA)
+  if (!_black_buffer) return; // arena not borrowed, outside of picture loop
+#endif
+  uint8_t* black = _black_buffer + i * buffer_stride;
+  uint8_t* red = _red_buffer + i * buffer_stride;
+  uint8_t mask = 1 << (7 - x % 8);
+  // any other color is white
+  *black = (color == GxEPD_BLACK) ? (*black | mask) : (*black & ~mask);
+  *red = (color == GxEPD_RED) ? (*red | mask) : (*red & ~mask);
 }
 
 bool GxEPD2_32_3C::mirror(bool m)
@@ -84,7 +129,7 @@ bool GxEPD2_32_3C::mirror(bool m)
   return m;
 }
 
-void GxEPD2_32_3C::init()
+void GxEPD2_32_3C::init(bool resume)
 {
   //  Serial.print(WIDTH); Serial.print("x"); Serial.print(HEIGHT);
   //  Serial.print(" : "); Serial.print(_pages); Serial.print(" pages of ");
@@ -103,6 +148,9 @@ void GxEPD2_32_3C::init()
   {
     digitalWrite(_rst, HIGH);
     pinMode(_rst, OUTPUT);
+  }
+  if ((_rst >= 0) && !resume)
+  {
     delay(20);
     digitalWrite(_rst, LOW);
     delay(20);
@@ -113,24 +161,37 @@ void GxEPD2_32_3C::init()
   {
     pinMode(_busy, INPUT);
   }
-  SPI.begin();
-  SPI.setDataMode(SPI_MODE0);
-  SPI.setBitOrder(MSBFIRST);
-#if defined(SPI_HAS_TRANSACTION)
-  // true also for STM32F1xx Boards
-  SPISettings settings(4000000, MSBFIRST, SPI_MODE0);
-  SPI.beginTransaction(settings);
-  SPI.endTransaction();
-  //Serial.println("SPI has Transaction");
-#elif defined(ESP8266) || defined(ESP32)
-  SPI.setFrequency(4000000);
-#endif
+  GxEPD2::initSPI(); // once for all panels on the bus
   fillScreen(GxEPD_WHITE);
-  _initial = true;
-  _power_is_on = false;
+  if (!resume)
+  {
+    _initial = true;
+    _power_is_on = false;
+    _lut_mode = GxEPD2::LutNone;
+  }
   _current_page = -1;
 }
 
+void GxEPD2_32_3C::saveState(GxEPD2::RetainedState& state)
+{
+  state.magic = GxEPD2::RetainedStateMagic;
+  state.panel = _panel;
+  state.flags = (_initial ? GxEPD2::RetainedInitial : 0) | (_power_is_on ? GxEPD2::RetainedPowerIsOn : 0);
+  state.lut_mode = _lut_mode;
+  state.lut_scale = _lut_scale;
+  memset(state.partial_updates, 0, sizeof(state.partial_updates));
+}
+
+bool GxEPD2_32_3C::restoreState(const GxEPD2::RetainedState& state)
+{
+  if ((state.magic != GxEPD2::RetainedStateMagic) || (state.panel != _panel)) return false;
+  _initial = (state.flags & GxEPD2::RetainedInitial) != 0;
+  _power_is_on = (state.flags & GxEPD2::RetainedPowerIsOn) != 0;
+  _lut_mode = GxEPD2::LutMode(state.lut_mode);
+  _lut_scale = state.lut_scale;
+  return true;
+}
+
 void GxEPD2_32_3C::fillScreen(uint16_t color)
 {
   uint8_t black = 0x00;
@@ -138,28 +199,42 @@ void GxEPD2_32_3C::fillScreen(uint16_t color)
   if (color == GxEPD_WHITE);
   else if (color == GxEPD_BLACK) black = 0xFF;
   else if (color == GxEPD_RED) red = 0xFF;
-  for (uint16_t x = 0; x < sizeof(_black_buffer); x++)
+#if defined(GxEPD2_BUFFER_ARENA)
+  if (!_black_buffer) return;
+#endif
+  for (uint16_t x = 0; x < _buffer_size; x++)
   {
-    _black_buffer[x] = black;
-    _red_buffer[x] = red;
+    _black_buffer[x * buffer_stride] = black;
+    _red_buffer[x * buffer_stride] = red;
   }
 }
 
 void GxEPD2_32_3C::setFullWindow()
 {
   _using_partial_mode = false;
+  _window_count = 0;
+  _setPageArea(0, 0, WIDTH, HEIGHT);
 }
 
 void GxEPD2_32_3C::setPartialWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+  _window_count = 0;
+  addPartialWindow(x, y, w, h);
+}
+
+void GxEPD2_32_3C::addPartialWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
 {
   if (_panel != GxEPD2::GDEW0154Z04)
   {
     _rotate(x, y, w, h);
     _using_partial_mode = true;
-    _pw_x = gx_uint16_min(x, WIDTH);
-    _pw_y = gx_uint16_min(y, HEIGHT);
-    _pw_w = gx_uint16_min(w, WIDTH - _pw_x);
-    _pw_h = gx_uint16_min(h, HEIGHT - _pw_y);
+    x = gx_uint16_min(x, WIDTH);
+    y = gx_uint16_min(y, HEIGHT);
+    w = gx_uint16_min(w, WIDTH - x);
+    h = gx_uint16_min(h, HEIGHT - y);
+    if ((_window_count > 0) && ((w == 0) || (h == 0))) return;
+    _window_count = GxEPD2::addWindow(_windows, _window_count, max_windows, x, y, w, h);
+    _selectWindow(0);
   }
   else
   {
@@ -169,6 +244,7 @@ void GxEPD2_32_3C::setPartialWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t
 
 void GxEPD2_32_3C::firstPage()
 {
+  if (!_borrowBuffer()) return;
   _current_page = 0;
   _second_phase = false;
   if (!_using_partial_mode)
@@ -178,29 +254,107 @@ void GxEPD2_32_3C::firstPage()
   }
   else
   {
+    _selectWindow(0);
     if ((_pw_w > 0) && (_pw_h > 0))
     {
-      switch (_panel)
+      _Init_Part();
+      if (_panel != GxEPD2::GDEW027C44)
       {
-        case GxEPD2::GDEW0213Z16:
-        case GxEPD2::GDEW029Z10:
-        case GxEPD2::GDEW042Z15:
-        case GxEPD2::GDEW075Z09:
-          _Init_Part();
-          _writeCommand(0x91); // partial in
-          _setPartialRamArea(_pw_x, _pw_y, _pw_w, _pw_h);
-          _writeCommand(0x10);
-          break;
-        case GxEPD2::GDEW027C44:
-          _Init_Part();
-          _setPartialRamArea27(0x14, _pw_x, _pw_y, _pw_w, _pw_h);
-          break;
+        _writeCommand(0x91); // partial in
       }
+      _setWindowRamArea();
     }
   }
+  GxEPD2_STAT(_render_start = micros());
 }
 
 bool GxEPD2_32_3C::nextPage()
+{
+#if defined(GxEPD2_BUFFER_ARENA)
+  if (!_black_buffer) return false; // firstPage() got no buffer
+#endif
+  GxEPD2_STAT(_stats.render_us += micros() - _render_start; _stats.pages++);
+  bool more = _nextPage();
+  if (!more) _releaseBuffer();
+  GxEPD2_STAT(_render_start = micros());
+  return more;
+}
+
+const GxEPD2::Statistics& GxEPD2_32_3C::statistics()
+{
+#if defined(GxEPD2_STATISTICS)
+  return _stats;
+#else
+  static const GxEPD2::Statistics none = {};
+  return none;
+#endif
+}
+
+#if defined(GxEPD2_BUFFER_ARENA)
+bool GxEPD2_32_3C::setArena(GxEPD2_32_Arena& arena)
+{
+  // a page is at least one row
+  if (arena.size() / 2 < _width_bytes) return false;
+  _arena = &arena;
+  _buffer_size = arena.size() / 2;
+  _setPageArea(0, 0, WIDTH, HEIGHT);
+  return true;
+}
+#endif
+
+bool GxEPD2_32_3C::pageBufferAvailable()
+{
+#if defined(GxEPD2_BUFFER_ARENA)
+  return (_arena && _arena->available(this));
+#else
+  return true;
+#endif
+}
+
+void GxEPD2_32_3C::setTemperature(int8_t celsius)
+{
+  _lut_scale = GxEPD2::lutFrameScale(celsius);
+}
+
+void GxEPD2_32_3C::setBusyCallback(void (*busyCallback)(const void*, GxEPD2::BusyPhase), const void* busy_callback_parameter)
+{
+  _busy_callback = busyCallback;
+  _busy_callback_parameter = busy_callback_parameter;
+}
+
+void GxEPD2_32_3C::resetStatistics()
+{
+  GxEPD2_STAT(memset(&_stats, 0, sizeof(_stats)));
+}
+
+void GxEPD2_32_3C::_setBuffers(uint8_t* buffer)
+{
+  _black_buffer = buffer;
+  _red_buffer = buffer ? buffer + ((buffer_stride > 1) ? 1 : _buffer_size) : 0;
+}
+
+bool GxEPD2_32_3C::_borrowBuffer()
+{
+#if defined(GxEPD2_BUFFER_ARENA)
+  _setBuffers(_arena ? _arena->borrow(this) : 0);
+  if (!_black_buffer)
+  {
+    Serial.println("firstPage : page buffer arena not set or in use");
+    return false;
+  }
+#endif
+  return true;
+}
+
+void GxEPD2_32_3C::_releaseBuffer()
+{
+#if defined(GxEPD2_BUFFER_ARENA)
+  if (_arena) _arena->release(this);
+  _setBuffers(0);
+#endif
+}
+
+bool GxEPD2_32_3C::_nextPage()
 {
   if (!_using_partial_mode)
   {
@@ -273,10 +427,13 @@ void GxEPD2_32_3C::clearScreen(uint8_t black_value, uint8_t red_value)
     case GxEPD2::GDEW0154Z04:
       _Init_Full();
       _writeCommand(0x10);
-      for (int16_t i = 0; i < WIDTH * HEIGHT / 8; i++)
       {
-        _writeData(bw2grey[(black_value & 0xF0) >> 4]);
-        _writeData(bw2grey[black_value & 0x0F]);
+        uint8_t row[grey_row_bytes];
+        memset(row, black_value, sizeof(row));
+        for (int16_t i = 0; i < HEIGHT; i++)
+        {
+          _writeDataGrey(row, WIDTH / 8);
+        }
       }
       _writeCommand(0x13);
       for (int16_t i = 0; i < WIDTH * HEIGHT / 8; i++)
@@ -317,7 +474,7 @@ void GxEPD2_32_3C::clearScreen(uint8_t black_value, uint8_t red_value)
         _writeData(~red_value);
       }
       _refreshWindow(0, 0, WIDTH, HEIGHT);
-      _waitWhileBusy("clearScreen");
+      _waitWhileBusy("clearScreen", GxEPD2::BusyUpdatePart);
       break;
     case GxEPD2::GDEW075Z09:
       _Init_Part();
@@ -341,10 +498,13 @@ void GxEPD2_32_3C::writeScreenBuffer(uint8_t black_value, uint8_t red_value)
     case GxEPD2::GDEW0154Z04:
       _Init_Full();
       _writeCommand(0x10);
-      for (int16_t i = 0; i < WIDTH * HEIGHT / 8; i++)
       {
-        _writeData(bw2grey[(black_value & 0xF0) >> 4]);
-        _writeData(bw2grey[black_value & 0x0F]);
+        uint8_t row[grey_row_bytes];
+        memset(row, black_value, sizeof(row));
+        for (int16_t i = 0; i < HEIGHT; i++)
+        {
+          _writeDataGrey(row, WIDTH / 8);
+        }
       }
       _writeCommand(0x13);
       for (int16_t i = 0; i < WIDTH * HEIGHT / 8; i++)
@@ -423,15 +583,16 @@ void GxEPD2_32_3C::writeImage(const uint8_t* black, const uint8_t* red, int16_t
       _writeCommand(0x10);
       for (int16_t i = 0; i < HEIGHT; i++)
       {
+        uint8_t row[grey_row_bytes];
         for (int16_t j = 0; j < WIDTH; j += 8)
         {
           uint8_t data = 0xFF;
           if (black)
           {
             // use wb, h of bitmap for index!
-            if (((x + j) >= 0) && ((x + j) < w) && ((y + i) >= 0) && ((y + i) < h))
+            if (((j - x) >= 0) && ((j - x) < w) && ((i - y) >= 0) && ((i - y) < h))
             {
-              int16_t idx = mirror_y ? j + dx / 8 + ((h - 1 - (i + dy))) * wb : j + dx / 8 + (i + dy) * wb;
+              int16_t idx = mirror_y ? (j - x) / 8 + (h - 1 - (i - y)) * wb : (j - x) / 8 + (i - y) * wb;
               if (pgm)
               {
 #if defined(__AVR) || defined(ESP8266) || defined(ESP32)
@@ -447,10 +608,9 @@ void GxEPD2_32_3C::writeImage(const uint8_t* black, const uint8_t* red, int16_t
               if (invert) data = ~data;
             }
           }
-          //_writeData(data);
-          _writeData(bw2grey[(data & 0xF0) >> 4]);
-          _writeData(bw2grey[data & 0x0F]);
+          row[j / 8] = data;
         }
+        _writeDataGrey(row, WIDTH / 8);
       }
       _writeCommand(0x13);
       for (int16_t i = 0; i < HEIGHT; i++)
@@ -461,9 +621,9 @@ void GxEPD2_32_3C::writeImage(const uint8_t* black, const uint8_t* red, int16_t
           if (red)
           {
             // use wb, h of bitmap for index!
-            if (((x + j) >= 0) && ((x + j) < w) && ((y + i) >= 0) && ((y + i) < h))
+            if (((j - x) >= 0) && ((j - x) < w) && ((i - y) >= 0) && ((i - y) < h))
             {
-              int16_t idx = mirror_y ? j + dx / 8 + ((h - 1 - (i + dy))) * wb : j + dx / 8 + (i + dy) * wb;
+              int16_t idx = mirror_y ? (j - x) / 8 + (h - 1 - (i - y)) * wb : (j - x) / 8 + (i - y) * wb;
               if (pgm)
               {
 #if defined(__AVR) || defined(ESP8266) || defined(ESP32)
@@ -631,6 +791,159 @@ void GxEPD2_32_3C::drawImage(const uint8_t* black, const uint8_t* red, int16_t x
   refresh(x, y, w, h);
 }
 
+void GxEPD2_32_3C::beginImage(int16_t x, int16_t y, int16_t w, int16_t h, bool bottom_up)
+{
+  _image_active = false;
+  if (_panel == GxEPD2::GDEW0154Z04)
+  {
+    Serial.println("GDEW0154Z04 does not support beginImage, use writeImage");
+    return;
+  }
+  int16_t wb = (w + 7) / 8; // width bytes, rows are padded
+  x -= x % 8; // byte boundary
+  w = wb * 8; // byte boundary
+  int16_t x1 = x < 0 ? 0 : x; // limit
+  int16_t y1 = y < 0 ? 0 : y; // limit
+  int16_t w1 = x + w < WIDTH ? w : WIDTH - x; // limit
+  int16_t h1 = y + h < HEIGHT ? h : HEIGHT - y; // limit
+  int16_t dx = x1 - x;
+  int16_t dy = y1 - y;
+  w1 -= dx;
+  h1 -= dy;
+  if ((w1 <= 0) || (h1 <= 0)) return;
+  _image_wb = wb;
+  _image_dxb = dx / 8;
+  _image_w1b = w1 / 8;
+  _image_dy = dy;
+  _image_h = h;
+  _image_h1 = h1;
+  _image_row = 0;
+  _image_x1 = x1;
+  _image_y1 = y1;
+  _image_bottom_up = bottom_up;
+  _Init_Part();
+  switch (_panel)
+  {
+    case GxEPD2::GDEW075Z09:
+      // one data plane, the window is set once, or a band window per writeImageRows() if bottom up
+      _writeCommand(0x91); // partial in
+      if (bottom_up) break;
+      _setPartialRamArea(x1, y1, w1, h1);
+      _writeCommand(0x10);
+      break;
+    case GxEPD2::GDEW0213Z16:
+    case GxEPD2::GDEW029Z10:
+    case GxEPD2::GDEW042Z15:
+      // separate black and red planes, a band window per writeImageRows()
+      _writeCommand(0x91); // partial in
+      break;
+  }
+  _image_active = true;
+}
+
+void GxEPD2_32_3C::writeImageRows(const uint8_t bitmap[], int16_t rows, bool invert, bool pgm)
+{
+  writeImageRows(bitmap, NULL, rows, invert, pgm);
+}
+
+void GxEPD2_32_3C::writeImageRows(const uint8_t* black, const uint8_t* red, int16_t rows, bool invert, bool pgm)
+{
+  if (!_image_active) return;
+  int16_t first = _image_row;
+  _image_row += rows;
+  // image rows of this call, top to bottom, inside the clipped image
+  int16_t lo = _image_bottom_up ? _image_h - first - rows : first;
+  int16_t hi = lo + rows;
+  if (lo < _image_dy) lo = _image_dy;
+  if (hi > _image_dy + _image_h1) hi = _image_dy + _image_h1;
+  if (hi <= lo) return;
+  uint16_t y = _image_y1 + lo - _image_dy;
+  uint16_t h = hi - lo;
+  switch (_panel)
+  {
+    case GxEPD2::GDEW075Z09:
+      if (_image_bottom_up)
+      {
+        _setPartialRamArea(_image_x1, y, _image_w1b * 8, h);
+        _writeCommand(0x10);
+      }
+      for (int16_t r = lo; r < hi; r++)
+      {
+        uint16_t offset = _imageBufferRow(first, r) * _image_wb + _image_dxb;
+        for (int16_t j = 0; j < _image_w1b; j++)
+        {
+          uint8_t black_data = black ? _imageData(black, offset + j, invert, pgm) : 0xFF;
+          uint8_t red_data = red ? _imageData(red, offset + j, invert, pgm) : 0xFF;
+          _send8pixel(~black_data, ~red_data);
+        }
+      }
+      return;
+    case GxEPD2::GDEW0213Z16:
+    case GxEPD2::GDEW029Z10:
+    case GxEPD2::GDEW042Z15:
+      _setPartialRamArea(_image_x1, y, _image_w1b * 8, h);
+      _writeCommand(0x10);
+      _writeImagePlane(black, first, lo, hi, invert, pgm, false);
+      _writeCommand(0x13);
+      _writeImagePlane(red, first, lo, hi, invert, pgm, false);
+      return;
+    case GxEPD2::GDEW027C44:
+      _setPartialRamArea27(0x14, _image_x1, y, _image_w1b * 8, h);
+      _writeImagePlane(black, first, lo, hi, invert, pgm, true);
+      _setPartialRamArea27(0x15, _image_x1, y, _image_w1b * 8, h);
+      _writeImagePlane(red, first, lo, hi, invert, pgm, true);
+      return;
+  }
+}
+
+void GxEPD2_32_3C::endImage()
+{
+  if (!_image_active) return;
+  if (_panel != GxEPD2::GDEW027C44)
+  {
+    _writeCommand(0x92); // partial out
+  }
+  _image_active = false;
+}
+
+uint8_t GxEPD2_32_3C::_imageData(const uint8_t* bitmap, uint16_t idx, bool invert, bool pgm)
+{
+  uint8_t data;
+  if (pgm)
+  {
+#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
+    data = pgm_read_byte(&bitmap[idx]);
+#else
+    data = bitmap[idx];
+#endif
+  }
+  else
+  {
+    data = bitmap[idx];
+  }
+  return invert ? ~data : data;
+}
+
+int16_t GxEPD2_32_3C::_imageBufferRow(int16_t first, int16_t r)
+{
+  // row index in the rows passed to writeImageRows(), for image row r
+  return _image_bottom_up ? _image_h - 1 - first - r : r - first;
+}
+
+void GxEPD2_32_3C::_writeImagePlane(const uint8_t* plane, int16_t first, int16_t lo, int16_t hi, bool invert, bool pgm, bool inverted_ram)
+{
+  for (int16_t r = lo; r < hi; r++)
+  {
+    uint16_t offset = _imageBufferRow(first, r) * _image_wb + _image_dxb;
+    for (int16_t j = 0; j < _image_w1b; j++)
+    {
+      uint8_t data = plane ? _imageData(plane, offset + j, invert, pgm) : 0xFF;
+      if (inverted_ram) data = ~data;
+      _writeData(data);
+    }
+  }
+}
+
 void GxEPD2_32_3C::refresh(bool partial_update_mode)
 {
   if (partial_update_mode) refresh(0, 0, WIDTH, HEIGHT);
@@ -662,7 +975,7 @@ void GxEPD2_32_3C::refresh(int16_t x, int16_t y, int16_t w, int16_t h)
       break;
     case GxEPD2::GDEW027C44:
       _refreshWindow(x1, y1, w1, h1);
-      _waitWhileBusy("refresh");
+      _waitWhileBusy("refresh", GxEPD2::BusyUpdatePart);
       break;
   }
 }
@@ -670,12 +983,12 @@ void GxEPD2_32_3C::refresh(int16_t x, int16_t y, int16_t w, int16_t h)
 bool GxEPD2_32_3C::_nextPageFull()
 {
   uint16_t page_ys = _current_page * _page_height;
-  uint16_t bytes = (_current_page < (_pages - 1) ? _page_height : HEIGHT - page_ys) * _width_bytes;
+  uint16_t bytes = (_current_page < (_pages - 1) ? _page_height : _area_height - page_ys) * _area_width_bytes;
   if (!_second_phase)
   {
     for (uint16_t idx = 0; idx < bytes; idx++)
     {
-      uint8_t data = (idx < sizeof(_black_buffer)) ? _black_buffer[idx] : 0x00;
+      uint8_t data = _planeByte(_black_buffer, idx);
       _writeData(~data);
     }
     _current_page++;
@@ -690,7 +1003,7 @@ bool GxEPD2_32_3C::_nextPageFull()
   }
   for (uint16_t idx = 0; idx < bytes; idx++)
   {
-    uint8_t data = (idx < sizeof(_red_buffer)) ? _red_buffer[idx] : 0x00;
+    uint8_t data = _planeByte(_red_buffer, idx);
     _writeData(~data);
   }
   _current_page++;
@@ -708,25 +1021,12 @@ bool GxEPD2_32_3C::_nextPageFull()
 bool GxEPD2_32_3C::_nextPagePart()
 {
   uint16_t page_ys = _current_page * _page_height;
-  uint16_t page_ye = _current_page < (_pages - 1) ? page_ys + _page_height : HEIGHT;
-  uint16_t dest_ys = gx_uint16_max(_pw_y, page_ys);
-  uint16_t dest_ye = gx_uint16_min(_pw_y + _pw_h, page_ye);
-  if (dest_ye > dest_ys)
-  {
-    uint16_t xs_d8 = _pw_x / 8;
-    uint16_t xe_d8 = (_pw_x + _pw_w + 7) / 8;
-    uint16_t ys = dest_ys - page_ys;
-    uint16_t ye = dest_ye - page_ys;
-    uint8_t* buffer = _second_phase ? _red_buffer : _black_buffer;
-    for (uint16_t y = ys; y < ye; y++)
-    {
-      for (uint16_t x = xs_d8; x < xe_d8; x++)
-      {
-        uint16_t idx = x + y * _width_bytes;
-        uint8_t data = (idx < sizeof(_black_buffer)) ? buffer[idx] : 0x00;
-        _writeData(~data);
-      }
-    }
+  uint16_t bytes = (_current_page < (_pages - 1) ? _page_height : _area_height - page_ys) * _area_width_bytes;
+  uint8_t* buffer = _second_phase ? _red_buffer : _black_buffer;
+  for (uint16_t idx = 0; idx < bytes; idx++)
+  {
+    uint8_t data = _planeByte(buffer, idx);
+    _writeData(~data);
   }
   _current_page++;
   if (_current_page < _pages)
@@ -734,21 +1034,26 @@ bool GxEPD2_32_3C::_nextPagePart()
     fillScreen(GxEPD_WHITE);
     return true;
   }
+  if (_nextWindow()) return true;
   if (!_second_phase)
   {
     fillScreen(GxEPD_WHITE);
     _second_phase = true;
     _current_page = 0;
-    _writeCommand(0x13);
+    _selectWindow(0);
+    _setWindowRamArea();
     return true;
   }
 #ifdef USE_PARTIAL_UPDATE_WORKAROUND_ON_GDEW042Z15
   if (_panel == GxEPD2::GDEW042Z15)
   {
     _setPartialRamArea(0, 0, WIDTH, HEIGHT);
+    _Update_Part();
   }
+  else _refreshWindows();
+#else
+  _refreshWindows();
 #endif
-  _Update_Part();
   _writeCommand(0x92); // partial out
   delay(200);
   _current_page = -1;
@@ -758,15 +1063,10 @@ bool GxEPD2_32_3C::_nextPagePart()
 bool GxEPD2_32_3C::_nextPageFull154()
 {
   uint16_t page_ys = _current_page * _page_height;
-  uint16_t bytes = (_current_page < (_pages - 1) ? _page_height : HEIGHT - page_ys) * _width_bytes;
+  uint16_t bytes = (_current_page < (_pages - 1) ? _page_height : _area_height - page_ys) * _area_width_bytes;
   if (!_second_phase)
   {
-    for (uint16_t idx = 0; idx < bytes; idx++)
-    {
-      uint8_t data = (idx < sizeof(_black_buffer)) ? ~_black_buffer[idx] : 0xFF;
-      _writeData(bw2grey[(data & 0xF0) >> 4]);
-      _writeData(bw2grey[data & 0x0F]);
-    }
+    _writeDataGrey(_black_buffer, bytes, 0xFF, buffer_stride);
     _current_page++;
     if (_current_page < _pages)
     {
@@ -781,7 +1081,7 @@ bool GxEPD2_32_3C::_nextPageFull154()
   }
   for (uint16_t idx = 0; idx < bytes; idx++)
   {
-    _writeData((idx < sizeof(_red_buffer)) ? ~_red_buffer[idx] : 0xFF);
+    _writeData(~_planeByte(_red_buffer, idx));
   }
   _current_page++;
   if (_current_page < _pages)
@@ -798,12 +1098,12 @@ bool GxEPD2_32_3C::_nextPageFull154()
 bool GxEPD2_32_3C::_nextPageFull27()
 {
   uint16_t page_ys = _current_page * _page_height;
-  uint16_t bytes = (_current_page < (_pages - 1) ? _page_height : HEIGHT - page_ys) * _width_bytes;
+  uint16_t bytes = (_current_page < (_pages - 1) ? _page_height : _area_height - page_ys) * _area_width_bytes;
   if (!_second_phase)
   {
     for (uint16_t idx = 0; idx < bytes; idx++)
     {
-      uint8_t data = (idx < sizeof(_black_buffer)) ? _black_buffer[idx] : 0x00;
+      uint8_t data = _planeByte(_black_buffer, idx);
       _writeData(data);
     }
     _current_page++;
@@ -820,7 +1120,7 @@ bool GxEPD2_32_3C::_nextPageFull27()
   }
   for (uint16_t idx = 0; idx < bytes; idx++)
   {
-    uint8_t data = (idx < sizeof(_red_buffer)) ? _red_buffer[idx] : 0x00;
+    uint8_t data = _planeByte(_red_buffer, idx);
     _writeData(data);
   }
   _current_page++;
@@ -838,25 +1138,12 @@ bool GxEPD2_32_3C::_nextPageFull27()
 bool GxEPD2_32_3C::_nextPagePart27()
 {
   uint16_t page_ys = _current_page * _page_height;
-  uint16_t page_ye = _current_page < (_pages - 1) ? page_ys + _page_height : HEIGHT;
-  uint16_t dest_ys = gx_uint16_max(_pw_y, page_ys);
-  uint16_t dest_ye = gx_uint16_min(_pw_y + _pw_h, page_ye);
-  if (dest_ye > dest_ys)
-  {
-    uint16_t xs_d8 = _pw_x / 8; // byte boundary
-    uint16_t xe_d8 = ((_pw_x + _pw_w - 1) | 0x0007) / 8; // byte boundary inclusive (last byte)
-    uint16_t ys = dest_ys - page_ys;
-    uint16_t ye = dest_ye - page_ys; // exclusive
-    uint8_t* buffer = _second_phase ? _red_buffer : _black_buffer;
-    for (uint16_t y = ys; y < ye; y++)
-    {
-      for (uint16_t x = xs_d8; x <= xe_d8; x++)
-      {
-        uint16_t idx = x + y * _width_bytes;
-        uint8_t data = (idx < sizeof(_black_buffer)) ? buffer[idx] : 0x00;
-        _writeData(data);
-      }
-    }
+  uint16_t bytes = (_current_page < (_pages - 1) ? _page_height : _area_height - page_ys) * _area_width_bytes;
+  uint8_t* buffer = _second_phase ? _red_buffer : _black_buffer;
+  for (uint16_t idx = 0; idx < bytes; idx++)
+  {
+    uint8_t data = _planeByte(buffer, idx);
+    _writeData(data);
   }
   _current_page++;
   if (_current_page < _pages)
@@ -864,16 +1151,17 @@ bool GxEPD2_32_3C::_nextPagePart27()
     fillScreen(GxEPD_WHITE);
     return true;
   }
+  if (_nextWindow()) return true;
   if (!_second_phase)
   {
     fillScreen(GxEPD_WHITE);
     _second_phase = true;
     _current_page = 0;
-    _setPartialRamArea27(0x15, _pw_x, _pw_y, _pw_w, _pw_h);
+    _selectWindow(0);
+    _setWindowRamArea();
     return true;
   }
-  _refreshWindow(_pw_x, _pw_y, _pw_w, _pw_h);
-  _waitWhileBusy("_nextPage27");
+  _refreshWindows();
   delay(500); // don't stress this display
   _current_page = -1;
   return false;
@@ -882,10 +1170,10 @@ bool GxEPD2_32_3C::_nextPagePart27()
 bool GxEPD2_32_3C::_nextPageFull75()
 {
   uint16_t page_ys = _current_page * _page_height;
-  uint16_t bytes = (_current_page < (_pages - 1) ? _page_height : HEIGHT - page_ys) * _width_bytes;
+  uint16_t bytes = (_current_page < (_pages - 1) ? _page_height : _area_height - page_ys) * _area_width_bytes;
   for (uint16_t idx = 0; idx < bytes; idx++)
   {
-    _send8pixel(_black_buffer[idx], _red_buffer[idx]);
+    _send8pixel(_black_buffer[idx * buffer_stride], _red_buffer[idx * buffer_stride]);
   }
   _current_page++;
   if (_current_page < _pages)
@@ -902,23 +1190,10 @@ bool GxEPD2_32_3C::_nextPageFull75()
 bool GxEPD2_32_3C::_nextPagePart75()
 {
   uint16_t page_ys = _current_page * _page_height;
-  uint16_t page_ye = _current_page < (_pages - 1) ? page_ys + _page_height : HEIGHT;
-  uint16_t dest_ys = gx_uint16_max(_pw_y, page_ys);
-  uint16_t dest_ye = gx_uint16_min(_pw_y + _pw_h, page_ye);
-  if (dest_ye > dest_ys)
-  {
-    uint16_t xe_d8 = ((_pw_x + _pw_w - 1) | 0x0007) / 8; // byte boundary inclusive (last byte)
-    uint16_t xs_d8 = _pw_x / 8; // byte boundary
-    uint16_t ys = dest_ys - page_ys;
-    uint16_t ye = dest_ye - page_ys; // exclusive
-    for (uint16_t y = ys; y < ye; y++)
-    {
-      for (uint16_t x = xs_d8; x <= xe_d8; x++)
-      {
-        uint16_t idx = x + y * _width_bytes;
-        _send8pixel(_black_buffer[idx], _red_buffer[idx]);
-      }
-    }
+  uint16_t bytes = (_current_page < (_pages - 1) ? _page_height : _area_height - page_ys) * _area_width_bytes;
+  for (uint16_t idx = 0; idx < bytes; idx++)
+  {
+    _send8pixel(_black_buffer[idx * buffer_stride], _red_buffer[idx * buffer_stride]);
   }
   _current_page++;
   if (_current_page < _pages)
@@ -926,7 +1201,8 @@ bool GxEPD2_32_3C::_nextPagePart75()
     fillScreen(GxEPD_WHITE);
     return true;
   }
-  _Update_Part();
+  if (_nextWindow()) return true;
+  _refreshWindows();
   _writeCommand(0x92); // partial out
   _current_page = -1;
   return false;
@@ -934,73 +1210,114 @@ bool GxEPD2_32_3C::_nextPagePart75()
 
 void GxEPD2_32_3C::_send8pixel(uint8_t black_data, uint8_t red_data)
 {
-  for (uint8_t j = 0; j < 8; j++)
+  // black over red over white, 2 pixels per byte
+  for (uint8_t j = 0; j < 4; j++)
+  {
+    _writeData(br2pixels[((black_data >> 4) & 0x0C) | (red_data >> 6)]);
+    black_data <<= 2;
+    red_data <<= 2;
+  }
+}
+
+void GxEPD2_32_3C::_writeLut(const uint8_t* lut, uint8_t n, uint8_t offset)
+{
+  // rows of level select, 4 phase frame counts, repeat count, after offset bytes; frame counts scaled
+  uint8_t buf[64];
+  if ((_lut_scale == 100) || (n > sizeof(buf)))
+  {
+    _writeData_nCS(lut, n);
+    return;
+  }
+  for (uint8_t i = 0; i < n; i++)
   {
-    uint8_t t = 0x00; // black
-    if (black_data & 0x80); // keep black
-    else if (red_data & 0x80) t = 0x04; //red
-    else t = 0x03; // white
-    t <<= 4;
-    black_data <<= 1;
-    red_data <<= 1;
-    j++;
-    if (black_data & 0x80); // keep black
-    else if (red_data & 0x80) t |= 0x04; //red
-    else t |= 0x03; // white
-    black_data <<= 1;
-    red_data <<= 1;
-    _writeData(t);
+    uint8_t column = (i - offset) % 6;
+    bool frames = (i >= offset) && (i - offset < 7 * 6) && (column >= 1) && (column <= 4);
+    buf[i] = frames ? gx_uint16_min(uint16_t(lut[i]) * _lut_scale / 100, 0xFF) : lut[i];
   }
+  _writeData_nCS(buf, n);
 }
 
 void GxEPD2_32_3C::_writeCommand(uint8_t c)
 {
+  GxEPD2_TIME(uint32_t start = micros());
   if (_dc >= 0) digitalWrite(_dc, LOW);
   if (_cs >= 0) digitalWrite(_cs, LOW);
   SPI.transfer(c);
   if (_cs >= 0) digitalWrite(_cs, HIGH);
   if (_dc >= 0) digitalWrite(_dc, HIGH);
+  GxEPD2_STAT(_stats.spi_us += micros() - start; _stats.command_bytes++; _stats.cs_toggles += (_cs >= 0));
+  GxEPD2_TRC(_trace.command(c, start, micros()));
 }
 
 void GxEPD2_32_3C::_writeData(uint8_t d)
 {
+  GxEPD2_TIME(uint32_t start = micros());
   if (_cs >= 0) digitalWrite(_cs, LOW);
   SPI.transfer(d);
   if (_cs >= 0) digitalWrite(_cs, HIGH);
+  GxEPD2_STAT(_stats.spi_us += micros() - start; _stats.data_bytes++; _stats.cs_toggles += (_cs >= 0));
+  GxEPD2_TRC(_trace.data(d, 1, start, micros()));
 }
 
 void GxEPD2_32_3C::_writeData(const uint8_t* data, uint16_t n)
 {
+  GxEPD2_TIME(uint32_t start = micros());
   if (_cs >= 0) digitalWrite(_cs, LOW);
-  for (uint8_t i = 0; i < n; i++)
+  for (uint16_t i = 0; i < n; i++)
   {
     SPI.transfer(*data++);
   }
   if (_cs >= 0) digitalWrite(_cs, HIGH);
+  GxEPD2_STAT(_stats.spi_us += micros() - start; _stats.data_bytes += n; _stats.cs_toggles += (_cs >= 0));
+  GxEPD2_TRC(_trace.data((n > 0) ? data[-n] : 0, n, start, micros()));
+}
+
+void GxEPD2_32_3C::_writeDataGrey(const uint8_t* data, uint16_t n, uint8_t xor_value, uint8_t stride)
+{
+  // expand into a transmit buffer and send each burst under one chip select
+  uint8_t tx[2 * grey_row_bytes];
+  while (n > 0)
+  {
+    uint16_t burst = gx_uint16_min(n, grey_row_bytes);
+    for (uint16_t i = 0; i < burst; i++)
+    {
+      uint16_t grey = bw2grey[*data ^ xor_value];
+      data += stride;
+      tx[2 * i] = grey >> 8;
+      tx[2 * i + 1] = grey & 0xFF;
+    }
+    _writeData(tx, 2 * burst);
+    n -= burst;
+  }
 }
 
 void GxEPD2_32_3C::_writeData_nCS(const uint8_t* data, uint16_t n)
 {
-  for (uint8_t i = 0; i < n; i++)
+  GxEPD2_TIME(uint32_t start = micros());
+  for (uint16_t i = 0; i < n; i++)
   {
     if (_cs >= 0) digitalWrite(_cs, LOW);
     SPI.transfer(*data++);
     if (_cs >= 0) digitalWrite(_cs, HIGH);
   }
+  GxEPD2_STAT(_stats.spi_us += micros() - start; _stats.data_bytes += n; _stats.cs_toggles += (_cs >= 0) * n);
+  GxEPD2_TRC(_trace.data((n > 0) ? data[-n] : 0, n, start, micros()));
 }
 
-void GxEPD2_32_3C::_waitWhileBusy(const char* comment)
+void GxEPD2_32_3C::_waitWhileBusy(const char* comment, GxEPD2::BusyPhase phase)
 {
   unsigned long start = micros();
   while (1)
   {
     if (digitalRead(_busy) != _busy_active_level) break;
-    delay(1);
     if (micros() - start > (_panel == GxEPD2::GDEW075Z09 ? 40000000 : 20000000)) // > ? : >14.9s !
     {
       Serial.println("Busy Timeout!");
       break;
     }
+    // the pin is read again after the callback, which may take long
+    if (_busy_callback) _busy_callback(_busy_callback_parameter, phase);
+    else delay(1);
   }
   if (comment)
   {
@@ -1011,7 +1328,10 @@ void GxEPD2_32_3C::_waitWhileBusy(const char* comment)
     Serial.println(elapsed);
 #endif
   }
+  GxEPD2_STAT(_stats.busy_us[phase] += micros() - start);
+  GxEPD2_TRC(_trace.busy(phase, start, micros()));
   (void) start;
+  (void) phase;
 }
 
 void GxEPD2_32_3C::_setPartialRamArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
@@ -1071,16 +1391,97 @@ void GxEPD2_32_3C::_setPartialRamArea27(uint8_t command, uint16_t x, uint16_t y,
 void GxEPD2_32_3C::_refreshWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
 {
   w = (w + 7 + (x % 8)) & 0xfff8; // byte boundary exclusive (round up)
-  h = gx_uint16_min(h, 256); // strange controller error
-  _writeCommand(0x16);
-  _writeData(x >> 8);
-  _writeData(x & 0xf8);
-  _writeData(y >> 8);
-  _writeData(y & 0xff);
-  _writeData(w >> 8);
-  _writeData(w & 0xf8);
-  _writeData(h >> 8);
-  _writeData(h & 0xff);
+  // at most 256 rows per refresh (strange controller error), taller windows are refreshed in stacked stripes;
+  // the controller takes no commands while BUSY, so each stripe waits for the previous, the caller waits for the last
+  while (h > 0)
+  {
+    uint16_t hs = gx_uint16_min(h, 256);
+    _writeCommand(0x16);
+    _writeData(x >> 8);
+    _writeData(x & 0xf8);
+    _writeData(y >> 8);
+    _writeData(y & 0xff);
+    _writeData(w >> 8);
+    _writeData(w & 0xf8);
+    _writeData(hs >> 8);
+    _writeData(hs & 0xff);
+    y += hs;
+    h -= hs;
+    if (h > 0) _waitWhileBusy("_refreshWindow", GxEPD2::BusyUpdatePart);
+  }
+}
+
+void GxEPD2_32_3C::_selectWindow(uint8_t index)
+{
+  _window_index = index;
+  _pw_x = _windows[index].x;
+  _pw_y = _windows[index].y;
+  _pw_w = _windows[index].w;
+  _pw_h = _windows[index].h;
+  _setPageArea(_pw_x, _pw_y, _pw_w, _pw_h);
+}
+
+bool GxEPD2_32_3C::_nextWindow()
+{
+  if (_window_index + 1 >= _window_count) return false;
+  _selectWindow(_window_index + 1);
+  _setWindowRamArea();
+  fillScreen(GxEPD_WHITE);
+  _current_page = 0;
+  return true;
+}
+
+void GxEPD2_32_3C::_setWindowRamArea()
+{
+  switch (_panel)
+  {
+    case GxEPD2::GDEW0213Z16:
+    case GxEPD2::GDEW029Z10:
+    case GxEPD2::GDEW042Z15:
+    case GxEPD2::GDEW075Z09:
+      _setPartialRamArea(_pw_x, _pw_y, _pw_w, _pw_h);
+      _writeCommand(_second_phase ? 0x13 : 0x10);
+      break;
+    case GxEPD2::GDEW027C44:
+      _setPartialRamArea27(_second_phase ? 0x15 : 0x14, _pw_x, _pw_y, _pw_w, _pw_h);
+      break;
+  }
+}
+
+void GxEPD2_32_3C::_refreshWindows()
+{
+  // one refresh over the union of the windows, unless the union is much larger than the windows
+  uint16_t xs = WIDTH, ys = HEIGHT, xe = 0, ye = 0;
+  uint32_t area = 0;
+  for (uint8_t i = 0; i < _window_count; i++)
+  {
+    const GxEPD2::Window& pw = _windows[i];
+    xs = gx_uint16_min(xs, pw.x);
+    ys = gx_uint16_min(ys, pw.y);
+    xe = gx_uint16_max(xe, pw.x + pw.w);
+    ye = gx_uint16_max(ye, pw.y + pw.h);
+    area += uint32_t(pw.w) * pw.h;
+  }
+  bool merge = (_window_count < 2) || (uint32_t(xe - xs) * (ye - ys) <= 2 * area);
+  uint8_t n = merge ? 1 : _window_count;
+  for (uint8_t i = 0; i < n; i++)
+  {
+    GxEPD2::Window pw = merge ? GxEPD2::Window{xs, ys, uint16_t(xe - xs), uint16_t(ye - ys)} : _windows[i];
+    switch (_panel)
+    {
+      case GxEPD2::GDEW0213Z16:
+      case GxEPD2::GDEW029Z10:
+      case GxEPD2::GDEW042Z15:
+      case GxEPD2::GDEW075Z09:
+        _setPartialRamArea(pw.x, pw.y, pw.w, pw.h);
+        _Update_Part();
+        break;
+      case GxEPD2::GDEW027C44:
+        _refreshWindow(pw.x, pw.y, pw.w, pw.h);
+        _waitWhileBusy("_refreshWindows", GxEPD2::BusyUpdatePart);
+        break;
+    }
+  }
 }
 
 void GxEPD2_32_3C::_PowerOn(void)
@@ -1088,7 +1489,7 @@ void GxEPD2_32_3C::_PowerOn(void)
   if (!_power_is_on)
   {
     _writeCommand(0x04);
-    _waitWhileBusy("_PowerOn");
+    _waitWhileBusy("_PowerOn", GxEPD2::BusyPowerOn);
   }
   _power_is_on = true;
 }
@@ -1112,7 +1513,7 @@ void GxEPD2_32_3C::_PowerOff(void)
       break;
   }
   _writeCommand(0x02); // power off
-  _waitWhileBusy("_PowerOff");
+  _waitWhileBusy("_PowerOff", GxEPD2::BusyPowerOff);
   _power_is_on = false;
 }
 
@@ -1140,7 +1541,7 @@ void GxEPD2_32_3C::_InitDisplay()
       _writeData(0x07);
       _writeCommand(0x04);
       // power on needed here!
-      _waitWhileBusy("Power On");
+      _waitWhileBusy("Power On", GxEPD2::BusyPowerOn);
       _writeCommand(0X00);
       _writeData(0xcf);
       _writeCommand(0X50);
@@ -1252,7 +1653,7 @@ void GxEPD2_32_3C::_InitDisplay()
       _writeData (0x37);       //POWER SETTING
       _writeData (0x00);
       _writeCommand(0x04);     //POWER ON
-      _waitWhileBusy("POWER");
+      _waitWhileBusy("POWER", GxEPD2::BusyPowerOn);
       _writeCommand(0X00);     //PANNEL SETTING
       _writeData(0xCF);
       _writeData(0x08);
@@ -1283,6 +1684,7 @@ void GxEPD2_32_3C::_InitDisplay()
 
 void GxEPD2_32_3C::_Init_Full()
 {
+  GxEPD2_STAT(uint32_t start = micros());
   _InitDisplay();
   switch (_panel)
   {
@@ -1306,51 +1708,56 @@ void GxEPD2_32_3C::_Init_Full()
       break;
     case GxEPD2::GDEW027C44:
       _writeCommand(0x20); //vcom
-      _writeData_nCS(GxGDEW027C44_lut_20_vcomDC, sizeof(GxGDEW027C44_lut_20_vcomDC));
+      _writeLut(GxGDEW027C44_lut_20_vcomDC, sizeof(GxGDEW027C44_lut_20_vcomDC), 2);
       _writeCommand(0x21); //ww --
-      _writeData_nCS(GxGDEW027C44_lut_21, sizeof(GxGDEW027C44_lut_21));
+      _writeLut(GxGDEW027C44_lut_21, sizeof(GxGDEW027C44_lut_21));
       _writeCommand(0x22); //bw r
-      _writeData_nCS(GxGDEW027C44_lut_22_red, sizeof(GxGDEW027C44_lut_22_red));
+      _writeLut(GxGDEW027C44_lut_22_red, sizeof(GxGDEW027C44_lut_22_red));
       _writeCommand(0x23); //wb w
-      _writeData_nCS(GxGDEW027C44_lut_23_white, sizeof(GxGDEW027C44_lut_23_white));
+      _writeLut(GxGDEW027C44_lut_23_white, sizeof(GxGDEW027C44_lut_23_white));
       _writeCommand(0x24); //bb b
-      _writeData_nCS(GxGDEW027C44_lut_24_black, sizeof(GxGDEW027C44_lut_24_black));
+      _writeLut(GxGDEW027C44_lut_24_black, sizeof(GxGDEW027C44_lut_24_black));
       break;
   }
+  _lut_mode = GxEPD2::LutFull;
+  GxEPD2_STAT(_stats.init_us += micros() - start);
   _PowerOn();
 }
 
 void GxEPD2_32_3C::_Init_Part()
 {
+  GxEPD2_STAT(uint32_t start = micros());
   _InitDisplay();
   switch (_panel)
   {
     case GxEPD2::GDEW027C44:
       _writeCommand(0x20); //vcom
-      _writeData_nCS(GxGDEW027C44_lut_20_vcomDC, sizeof(GxGDEW027C44_lut_20_vcomDC));
+      _writeLut(GxGDEW027C44_lut_20_vcomDC, sizeof(GxGDEW027C44_lut_20_vcomDC), 2);
       _writeCommand(0x21); //ww --
-      _writeData_nCS(GxGDEW027C44_lut_21, sizeof(GxGDEW027C44_lut_21));
+      _writeLut(GxGDEW027C44_lut_21, sizeof(GxGDEW027C44_lut_21));
       _writeCommand(0x22); //bw r
-      _writeData_nCS(GxGDEW027C44_lut_22_red, sizeof(GxGDEW027C44_lut_22_red));
+      _writeLut(GxGDEW027C44_lut_22_red, sizeof(GxGDEW027C44_lut_22_red));
       _writeCommand(0x23); //wb w
-      _writeData_nCS(GxGDEW027C44_lut_23_white, sizeof(GxGDEW027C44_lut_23_white));
+      _writeLut(GxGDEW027C44_lut_23_white, sizeof(GxGDEW027C44_lut_23_white));
       _writeCommand(0x24); //bb b
-      _writeData_nCS(GxGDEW027C44_lut_24_black, sizeof(GxGDEW027C44_lut_24_black));
+      _writeLut(GxGDEW027C44_lut_24_black, sizeof(GxGDEW027C44_lut_24_black));
       break;
   }
+  _lut_mode = GxEPD2::LutPartial;
+  GxEPD2_STAT(_stats.init_us += micros() - start);
   _PowerOn();
 }
 
 void GxEPD2_32_3C::_Update_Full(void)
 {
   _writeCommand(0x12); //display refresh
-  _waitWhileBusy("_Update_Full");
+  _waitWhileBusy("_Update_Full", GxEPD2::BusyUpdateFull);
 }
 
 void GxEPD2_32_3C::_Update_Part(void)
 {
   _writeCommand(0x12); //display refresh
-  _waitWhileBusy("_Update_Part");
+  _waitWhileBusy("_Update_Part", GxEPD2::BusyUpdatePart);
 }
 
 void GxEPD2_32_3C::_rotate(uint16_t& x, uint16_t& y, uint16_t& w, uint16_t& h)
@@ -1374,4 +1781,13 @@ void GxEPD2_32_3C::_rotate(uint16_t& x, uint16_t& y, uint16_t& w, uint16_t& h)
   }
 }
 
-
+void GxEPD2_32_3C::_setPageArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+  // page buffer stride and height follow the area, to use the whole buffers also for small windows
+  _area_x = x & 0xFFF8; // byte boundary
+  _area_y = y;
+  _area_width_bytes = (w > 0) ? ((x + w - 1) / 8) - (x / 8) + 1 : 0; // incl. partial bytes
+  _area_height = h;
+  _page_height = _buffer_size / gx_uint16_max(_area_width_bytes, 1);
+  _pages = (h / _page_height) + ((h % _page_height) > 0);
+}
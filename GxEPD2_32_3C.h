@@ -17,10 +17,17 @@
 class GxEPD2_32_3C : public Adafruit_GFX
 {
   private:
+    static const uint8_t max_windows = 8;
+    static const uint8_t grey_row_bytes = 200 / 8; // GDEW0154Z04 row
     // 2 * ~15k full screen buffer for GDEW042Z15 is optimal (black/white + color/white)
     static const uint16_t buffer_size = 400 * 300 / 8; // 2 * 15'000 bytes
     // 2 * ~7.5k half screen buffer for GDEW042Z15 is a good compromise
     // static const uint16_t buffer_size = 400 * 300 / 8 / 2; // 2 * 7'500 bytes
+#if defined(GxEPD2_3C_INTERLEAVED)
+    static const uint8_t buffer_stride = 2; // black and red byte pairs, drawPixel touches one pair
+#else
+    static const uint8_t buffer_stride = 1; // black and red planes
+#endif
   public:
     GxEPD2_32_3C(GxEPD2::Panel panel, int8_t cs, int8_t dc, int8_t rst, int8_t busy);
     void drawPixel(int16_t x, int16_t y, uint16_t color);
@@ -41,12 +48,42 @@ class GxEPD2_32_3C : public Adafruit_GFX
       return false;
     }
     bool mirror(bool m);
-    void init();
+    // resume: after deep sleep with the controller still powered, skips the reset pulse
+    // and keeps the state set by restoreState(), e.g. no initial full refresh
+    void init(bool resume = false);
+    // before deep sleep, to memory that is retained, e.g. RTC_DATA_ATTR on ESP32
+    void saveState(GxEPD2::RetainedState& state);
+    // after wake up, before init(true); false if the state is not valid for this panel, then use init()
+    bool restoreState(const GxEPD2::RetainedState& state);
     void fillScreen(uint16_t color); // 0x0 black, >0x0 white, to buffer
     void setFullWindow();
     void setPartialWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+    // additional window for the same picture loop, windows are refreshed together; up to max_windows
+    void addPartialWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
     void firstPage();
     bool nextPage();
+    // transfer and timing statistics, collected only if GxEPD2_STATISTICS is defined in GxEPD2.h
+    const GxEPD2::Statistics& statistics();
+    void resetStatistics();
+#if defined(GxEPD2_TRACE)
+    // command stream trace, use trace().print(Serial) to export
+    GxEPD2_32_Trace& trace()
+    {
+      return _trace;
+    };
+#endif
+#if defined(GxEPD2_BUFFER_ARENA)
+    // page buffer for the picture loops, split into black and red halves, size up to 65535; call before init()
+    // false if a half is smaller than one row of the panel; then not set
+    bool setArena(GxEPD2_32_Arena& arena);
+#endif
+    // false if the shared page buffer is in use by another display
+    bool pageBufferAvailable();
+    // ambient temperature for the waveform, used from the next update, default room temperature;
+    // GDEW027C44 (LUT frame counts); the other panels use their internal sensor
+    void setTemperature(int8_t celsius);
+    // called repeatedly while waiting on BUSY, instead of delay(1); may do work for other devices, not for this display
+    void setBusyCallback(void (*busyCallback)(const void*, GxEPD2::BusyPhase), const void* busy_callback_parameter = 0);
     // partial update keeps power on
     void powerOff(void);
     void drawInvertedBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color);
@@ -59,9 +96,18 @@ class GxEPD2_32_3C : public Adafruit_GFX
     // write to controller memory, with screen refresh; x and w should be multiple of 8
     void drawImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
     void drawImage(const uint8_t* black, const uint8_t* red, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
+    // write to controller memory row by row, without screen refresh; x and w should be multiple of 8
+    // each row is w pixels padded to bytes; the black and red planes are separate in controller memory,
+    // so each writeImageRows() call sets its own band window, pass many rows per call; not for GDEW0154Z04
+    // bottom_up: rows come bottom first, e.g. BMP files
+    void beginImage(int16_t x, int16_t y, int16_t w, int16_t h, bool bottom_up = false);
+    void writeImageRows(const uint8_t bitmap[], int16_t rows, bool invert = false, bool pgm = false);
+    void writeImageRows(const uint8_t* black, const uint8_t* red, int16_t rows, bool invert = false, bool pgm = false);
+    void endImage();
     void refresh(bool partial_update_mode = false); // screen refresh from controller memory to full screen
     void refresh(int16_t x, int16_t y, int16_t w, int16_t h); // screen refresh from controller memory, partial screen
   private:
+    friend class GxEPD2_32_HostBenchmark; // extras/host, times the private pixel expansion
     template <typename T> static inline void
     swap(T& a, T& b)
     {
@@ -69,6 +115,10 @@ class GxEPD2_32_3C : public Adafruit_GFX
       a = b;
       b = t;
     }
+    void _setBuffers(uint8_t* buffer);
+    bool _borrowBuffer();
+    void _releaseBuffer();
+    bool _nextPage();
     bool _nextPageFull();
     bool _nextPagePart();
     bool _nextPageFull154();
@@ -77,23 +127,38 @@ class GxEPD2_32_3C : public Adafruit_GFX
     bool _nextPageFull75();
     bool _nextPagePart75();
     void _send8pixel(uint8_t black_data, uint8_t red_data);
+    void _writeLut(const uint8_t* lut, uint8_t n, uint8_t offset = 0);
     void _writeCommand(uint8_t c);
     void _writeData(uint8_t d);
     void _writeData(const uint8_t* data, uint16_t n);
     void _writeData_nCS(const uint8_t* data, uint16_t n);
+    uint8_t _planeByte(const uint8_t* plane, uint16_t idx)
+    {
+      return (idx < _buffer_size) ? plane[idx * buffer_stride] : 0x00;
+    };
+    uint8_t _imageData(const uint8_t* bitmap, uint16_t idx, bool invert, bool pgm);
+    int16_t _imageBufferRow(int16_t first, int16_t r);
+    void _writeImagePlane(const uint8_t* plane, int16_t first, int16_t lo, int16_t hi, bool invert, bool pgm, bool inverted_ram);
+    // GDEW0154Z04: b/w to grey expansion, sent in row bursts
+    void _writeDataGrey(const uint8_t* data, uint16_t n, uint8_t xor_value = 0x00, uint8_t stride = 1);
     void _setPartialRamArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
     void _setPartialRamArea27(uint8_t command, uint16_t x, uint16_t y, uint16_t w, uint16_t h);
     void _setRamEntryPartialWindow(uint8_t em);
     void _refreshWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
     void _PowerOn(void);
     void _PowerOff(void);
-    void _waitWhileBusy(const char* comment = 0);
+    void _waitWhileBusy(const char* comment = 0, GxEPD2::BusyPhase phase = GxEPD2::BusyOther);
     void _InitDisplay();
     void _Init_Full();
     void _Init_Part();
     void _Update_Full(void);
     void _Update_Part(void);
     void _rotate(uint16_t& x, uint16_t& y, uint16_t& w, uint16_t& h);
+    void _setPageArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+    void _selectWindow(uint8_t index);
+    bool _nextWindow();
+    void _setWindowRamArea();
+    void _refreshWindows();
     static inline uint16_t gx_uint16_min(uint16_t a, uint16_t b)
     {
       return (a < b ? a : b);
@@ -109,11 +174,34 @@ class GxEPD2_32_3C : public Adafruit_GFX
     uint16_t _width_bytes, _pixel_bytes;
     int16_t _current_page;
     uint16_t _pages, _page_height;
-    bool _initial, _power_is_on, _using_partial_mode, _second_phase, _mirror;
+    uint16_t _area_x, _area_y, _area_width_bytes, _area_height; // page buffer geometry
+    bool _initial, _power_is_on, _using_partial_mode, _second_phase, _mirror, _image_active, _image_bottom_up;
+    int16_t _image_wb, _image_dxb, _image_w1b, _image_dy, _image_h, _image_h1, _image_row; // beginImage() geometry
+    uint16_t _image_x1, _image_y1;
     uint16_t _pw_x, _pw_y, _pw_w, _pw_h;
-    uint8_t _black_buffer[buffer_size];
-    uint8_t _red_buffer[buffer_size];
-    static const uint8_t bw2grey[];
+    GxEPD2::Window _windows[max_windows];
+    uint8_t _window_count, _window_index;
+    GxEPD2::LutMode _lut_mode; // loaded by last _Init_Full() or _Init_Part()
+    uint16_t _lut_scale; // percent, see setTemperature()
+    void (*_busy_callback)(const void*, GxEPD2::BusyPhase);
+    const void* _busy_callback_parameter;
+#if defined(GxEPD2_STATISTICS)
+    GxEPD2::Statistics _stats;
+    uint32_t _render_start;
+#endif
+#if defined(GxEPD2_TRACE)
+    GxEPD2_32_Trace _trace;
+#endif
+#if defined(GxEPD2_BUFFER_ARENA)
+    GxEPD2_32_Arena* _arena; // borrowed during picture loops
+#else
+    uint8_t _buffer[2 * buffer_size];
+#endif
+    uint8_t* _black_buffer; // planes in _buffer or the arena, byte idx at [idx * buffer_stride]
+    uint8_t* _red_buffer;
+    uint16_t _buffer_size; // bytes per plane
+    static const uint16_t bw2grey[];
+    static const uint8_t br2pixels[];
 };
 
 #endif
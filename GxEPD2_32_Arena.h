@@ -0,0 +1,49 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_32
+//
+// Page buffer shared by several display instances, used if GxEPD2_BUFFER_ARENA is defined in GxEPD2.h.
+// A display borrows the arena in firstPage() and returns it when nextPage() returns false,
+// so only one picture loop can run at a time. Not synchronized, use from one task only.
+// GxEPD2_32_3C splits the arena into its black and red buffer halves.
+
+#ifndef _GxEPD2_32_Arena_H_
+#define _GxEPD2_32_Arena_H_
+
+#include <Arduino.h>
+
+class GxEPD2_32_Arena
+{
+  public:
+    GxEPD2_32_Arena(uint8_t* buffer, uint16_t size) : _buffer(buffer), _size(size), _owner(0) {}
+    uint16_t size()
+    {
+      return _size;
+    };
+    bool available(const void* owner)
+    {
+      return (!_owner || (_owner == owner));
+    };
+    // returns 0 if borrowed by another owner
+    uint8_t* borrow(const void* owner)
+    {
+      if (!available(owner)) return 0;
+      _owner = owner;
+      return _buffer;
+    };
+    void release(const void* owner)
+    {
+      if (_owner == owner) _owner = 0;
+    };
+  private:
+    uint8_t* _buffer;
+    uint16_t _size;
+    const void* _owner;
+};
+
+#endif
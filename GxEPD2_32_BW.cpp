@@ -15,21 +15,50 @@
 GxEPD2_32_BW::GxEPD2_32_BW(GxEPD2::Panel panel, int8_t cs, int8_t dc, int8_t rst, int8_t busy) :
   Adafruit_GFX(GxEPD2::ScreenDimensions[panel].width, GxEPD2::ScreenDimensions[panel].height),
   _panel(panel), _cs(cs), _dc(dc), _rst(rst), _busy(busy),
-  _current_page(-1), _using_partial_mode(false), _mirror(false)
+  _current_page(-1), _using_partial_mode(false), _mirror(false), _image_active(false), _window_count(0), _window_index(0),
+  _busy_callback(0), _busy_callback_parameter(0),
+#if defined(GxEPD2_BUFFER_ARENA)
+  _arena(0), _buffer(0),
+#endif
+  _page_buffer(_buffer)
+#if defined(GxEPD2_PIPELINE)
+  , _pipeline(_transmitPage, this)
+#endif
 {
   _initial = true;
   _power_is_on = false;
+  _lut_mode = GxEPD2::LutNone;
+  _lut_scale = 100;
+  _full_mode = GxEPD2::LutFull;
+  _partial_mode = GxEPD2::LutPartial;
+  for (uint8_t i = 0; i < GxEPD2::LutModes; i++)
+  {
+    _waveforms[i].tables = 0;
+    _waveforms[i].count = 0;
+  }
   _width_bytes = uint16_t(WIDTH) / 8; // just discard any (WIDTH % 8) pixels
   _pixel_bytes = _width_bytes * uint16_t(HEIGHT); // save uint16_t range
-  _page_height = buffer_size / _width_bytes;
-  _pages = (HEIGHT / _page_height) + ((HEIGHT % _page_height) > 0);
+  _grey = false;
+  _grey_shown = false;
+#if defined(GxEPD2_SHADOW)
+  memset(_shadow, 0xFF, sizeof(_shadow));
+  _old_synced = false;
+  _pending_x = _pending_y = _pending_xe = _pending_ye = 0;
+#endif
+  _setBufferSize(buffer_size);
+  resetStatistics();
   _ram_data_entry_mode  = (_panel == GxEPD2::GDE0213B1) ? 0x01 : 0x03;
   _reverse = (_panel == GxEPD2::GDE0213B1);
   _busy_active_level = (_panel < GxEPD2::GDEW027W3) ? HIGH : LOW;
+  _partial_update_budget = 0;
+  _resetPartialUpdates(0, 0, WIDTH, HEIGHT);
 }
 
 void GxEPD2_32_BW::drawPixel(int16_t x, int16_t y, uint16_t color)
 {
+#if defined(GxEPD2_BUFFER_ARENA)
+  if (!_page_buffer) return; // arena not borrowed, outside of picture loop
+#endif
   if ((x < 0) || (x >= width()) || (y < 0) || (y >= height())) return;
   if (_mirror) x = width() - x - 1;
   // check rotation, move pixel around if necessary
@@ -53,22 +82,27 @@ void GxEPD2_32_BW::drawPixel(int16_t x, int16_t y, uint16_t color)
     // flip y for y-decrement mode
     y = HEIGHT - y - 1;
   }
-  uint16_t i = x / 8 + y * _width_bytes;
-  if (_current_page < 1)
-  {
-    if (i >= sizeof(_buffer)) return;
-  }
-  else
+  // buffer covers the page area only, full screen or partial window
+  x -= _area_x;
+  y -= _area_y;
+  if ((x < 0) || (x >= _area_width_bytes * 8) || (y < 0) || (y >= _area_height)) return;
+  if (_current_page > 0) y -= _current_page * _page_height;
+  if ((y < 0) || (y >= _page_height)) return;
+  if (_grey)
   {
-    y -= _current_page * _page_height;
-    if ((y < 0) || (y >= _page_height)) return;
-    i = x / 8 + y * _width_bytes;
+    // 4 pixels per byte, 0 is white like in black/white mode
+    uint8_t level = (color == GxEPD_BLACK) ? 3 : (color == GxEPD_DARKGREY) ? 2 : (color == GxEPD_LIGHTGREY) ? 1 : 0;
+    uint16_t i = x / 4 + y * 2 * _area_width_bytes;
+    uint8_t shift = 6 - 2 * (x % 4);
+    _page_buffer[i] = (_page_buffer[i] & ~(0x03 << shift)) | (level << shift);
+    return;
   }
+  uint16_t i = x / 8 + y * _area_width_bytes;
 
   if (!color)
-    _buffer[i] = (_buffer[i] | (1 << (7 - x % 8)));
+    _page_buffer[i] = (_page_buffer[i] | (1 << (7 - x % 8)));
   else
-    _buffer[i] = (_buffer[i] & (0xFF ^ (1 << (7 - x % 8))));
+    _page_buffer[i] = (_page_buffer[i] & (0xFF ^ (1 << (7 - x % 8))));
 }
 
 bool GxEPD2_32_BW::mirror(bool m)
@@ -77,7 +111,7 @@ bool GxEPD2_32_BW::mirror(bool m)
   return m;
 }
 
-void GxEPD2_32_BW::init()
+void GxEPD2_32_BW::init(bool resume)
 {
   //  Serial.print(WIDTH); Serial.print("x"); Serial.print(HEIGHT);
   //  Serial.print(" : "); Serial.print(_pages); Serial.print(" pages of ");
@@ -96,6 +130,9 @@ void GxEPD2_32_BW::init()
   {
     digitalWrite(_rst, HIGH);
     pinMode(_rst, OUTPUT);
+  }
+  if ((_rst >= 0) && !resume)
+  {
     delay(20);
     digitalWrite(_rst, LOW);
     delay(20);
@@ -106,53 +143,98 @@ void GxEPD2_32_BW::init()
   {
     pinMode(_busy, INPUT);
   }
-  SPI.begin();
-  SPI.setDataMode(SPI_MODE0);
-  SPI.setBitOrder(MSBFIRST);
-#if defined(SPI_HAS_TRANSACTION)
-  // true also for STM32F1xx Boards
-  SPISettings settings(4000000, MSBFIRST, SPI_MODE0);
-  SPI.beginTransaction(settings);
-  SPI.endTransaction();
-  //Serial.println("SPI has Transaction");
-#elif defined(ESP8266) || defined(ESP32)
-  SPI.setFrequency(4000000);
-#endif
+  GxEPD2::initSPI(); // once for all panels on the bus
   fillScreen(GxEPD_WHITE);
-  _initial = true;
-  _power_is_on = false;
+  if (!resume)
+  {
+    _initial = true;
+    _power_is_on = false;
+    _lut_mode = GxEPD2::LutNone;
+  }
   _current_page = -1;
 }
 
+void GxEPD2_32_BW::saveState(GxEPD2::RetainedState& state)
+{
+  state.magic = GxEPD2::RetainedStateMagic;
+  state.panel = _panel;
+  state.flags = (_initial ? GxEPD2::RetainedInitial : 0) | (_power_is_on ? GxEPD2::RetainedPowerIsOn : 0);
+  state.lut_mode = _lut_mode;
+  state.lut_scale = _lut_scale;
+  for (uint8_t i = 0; i < sizeof(state.partial_updates); i++)
+  {
+    state.partial_updates[i] = (i < sizeof(_partial_updates)) ? _partial_updates[i] : 0;
+  }
+}
+
+bool GxEPD2_32_BW::restoreState(const GxEPD2::RetainedState& state)
+{
+  if ((state.magic != GxEPD2::RetainedStateMagic) || (state.panel != _panel)) return false;
+  _initial = (state.flags & GxEPD2::RetainedInitial) != 0;
+  _power_is_on = (state.flags & GxEPD2::RetainedPowerIsOn) != 0;
+  _lut_mode = GxEPD2::LutMode(state.lut_mode);
+  _lut_scale = state.lut_scale;
+#if defined(GxEPD2_SHADOW)
+  if (_panel == GxEPD2::GDEW042T2) _initial = true; // shadow not retained
+#endif
+  for (uint8_t i = 0; i < sizeof(_partial_updates); i++)
+  {
+    _partial_updates[i] = (i < sizeof(state.partial_updates)) ? state.partial_updates[i] : 0;
+  }
+  return true;
+}
+
 void GxEPD2_32_BW::fillScreen(uint16_t color)
 {
   uint8_t data = (color == GxEPD_BLACK) ? 0xFF : 0x00;
-  for (uint16_t x = 0; x < sizeof(_buffer); x++)
+  if (_grey) data = (color == GxEPD_BLACK) ? 0xFF : (color == GxEPD_DARKGREY) ? 0xAA : (color == GxEPD_LIGHTGREY) ? 0x55 : 0x00;
+#if defined(GxEPD2_BUFFER_ARENA)
+  if (!_page_buffer) return;
+#endif
+  for (uint16_t x = 0; x < _page_buffer_size; x++)
   {
-    _buffer[x] = data;
+    _page_buffer[x] = data;
   }
 }
 
 void GxEPD2_32_BW::setFullWindow()
 {
   _using_partial_mode = false;
+  _window_count = 0;
+  _setPageArea(0, 0, WIDTH, HEIGHT);
 }
 
 void GxEPD2_32_BW::setPartialWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+  _window_count = 0;
+  addPartialWindow(x, y, w, h);
+}
+
+void GxEPD2_32_BW::addPartialWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
 {
   _rotate(x, y, w, h);
   _using_partial_mode = true;
-  _pw_x = gx_uint16_min(x, WIDTH);
-  _pw_y = gx_uint16_min(y, HEIGHT);
-  _pw_w = gx_uint16_min(w, WIDTH - _pw_x);
-  _pw_h = gx_uint16_min(h, HEIGHT - _pw_y);
+  x = gx_uint16_min(x, WIDTH);
+  y = gx_uint16_min(y, HEIGHT);
+  w = gx_uint16_min(w, WIDTH - x);
+  h = gx_uint16_min(h, HEIGHT - y);
+  if ((_window_count > 0) && ((w == 0) || (h == 0))) return;
+  _window_count = GxEPD2::addWindow(_windows, _window_count, max_windows, x, y, w, h);
+  _selectWindow(0);
 }
 
 void GxEPD2_32_BW::firstPage()
 {
+  if (!_borrowBuffer()) return;
   _current_page = 0;
   _second_phase = false;
-  if (!_using_partial_mode)
+  if (_grey)
+  {
+    _setPageArea(0, 0, WIDTH, HEIGHT);
+    _Init_Waveform(_ram_data_entry_mode, GxEPD2::LutGrey);
+    _writeCommand(0x91); // partial in, a window per page for both planes
+  }
+  else if (!_using_partial_mode)
   {
     switch (_panel)
     {
@@ -175,38 +257,117 @@ void GxEPD2_32_BW::firstPage()
   }
   else
   {
+    _selectWindow(0);
     if ((_pw_w > 0) && (_pw_h > 0))
     {
-      switch (_panel)
+      _Init_Part(_ram_data_entry_mode);
+      if ((_panel == GxEPD2::GDEW042T2) || (_panel == GxEPD2::GDEW075T8))
       {
-        case GxEPD2::GDEP015OC1:
-        case GxEPD2::GDE0213B1:
-        case GxEPD2::GDEH029A1:
-          _Init_Part(_ram_data_entry_mode);
-          _setRamEntryWindow(_pw_x, _pw_y, _pw_w, _pw_h, _ram_data_entry_mode);
-          break;
-        case GxEPD2::GDEW027W3:
-          _Init_Part(_ram_data_entry_mode);
-          _setPartialRamArea(_pw_x, _pw_y, _pw_w, _pw_h);
-          break;
-        case GxEPD2::GDEW042T2:
-          _Init_Part(_ram_data_entry_mode);
-          _writeCommand(0x91); // partial in
-          _setPartialRamArea(_pw_x, _pw_y, _pw_w, _pw_h);
-          _writeCommand(0x13);
-          break;
-        case GxEPD2::GDEW075T8:
-          _Init_Part(_ram_data_entry_mode);
-          _writeCommand(0x91); // partial in
-          _setPartialRamArea(_pw_x, _pw_y, _pw_w, _pw_h);
-          _writeCommand(0x10);
+        _writeCommand(0x91); // partial in
       }
+      _setWindowRamArea();
     }
   }
+  GxEPD2_STAT(_render_start = micros());
 }
 
 bool GxEPD2_32_BW::nextPage()
 {
+#if defined(GxEPD2_BUFFER_ARENA)
+  if (!_page_buffer) return false; // firstPage() got no buffer
+#endif
+  GxEPD2_STAT(_stats.render_us += micros() - _render_start; _stats.pages++);
+  bool more = _nextPage();
+  if (!more) _releaseBuffer();
+  GxEPD2_STAT(_render_start = micros());
+  return more;
+}
+
+const GxEPD2::Statistics& GxEPD2_32_BW::statistics()
+{
+#if defined(GxEPD2_STATISTICS)
+  return _stats;
+#else
+  static const GxEPD2::Statistics none = {};
+  return none;
+#endif
+}
+
+#if defined(GxEPD2_BUFFER_ARENA)
+bool GxEPD2_32_BW::setArena(GxEPD2_32_Arena& arena)
+{
+  // a page is at least one row
+  uint16_t row_bytes = _width_bytes * (hasGreyLevels() ? 2 : 1);
+#if defined(GxEPD2_PIPELINE)
+  row_bytes *= 2;
+#endif
+  if (arena.size() < row_bytes) return false;
+  _arena = &arena;
+  _setBufferSize(arena.size());
+  return true;
+}
+#endif
+
+bool GxEPD2_32_BW::pageBufferAvailable()
+{
+#if defined(GxEPD2_BUFFER_ARENA)
+  return (_arena && _arena->available(this));
+#else
+  return true;
+#endif
+}
+
+void GxEPD2_32_BW::setTemperature(int8_t celsius)
+{
+  uint16_t scale = GxEPD2::lutFrameScale(celsius);
+  if (scale == _lut_scale) return;
+  _lut_scale = scale;
+  _lut_mode = GxEPD2::LutNone; // reload, scaled
+}
+
+bool GxEPD2_32_BW::setWaveform(GxEPD2::LutMode mode, const GxEPD2::LutTable* tables, uint8_t count)
+{
+  if ((mode == GxEPD2::LutNone) || (mode >= GxEPD2::LutModes) || (_panel == GxEPD2::GDEW075T8)) return false;
+  _waveforms[mode].tables = count ? tables : 0;
+  _waveforms[mode].count = tables ? count : 0;
+  if (mode == _lut_mode) _lut_mode = GxEPD2::LutNone;
+  return true;
+}
+
+bool GxEPD2_32_BW::setGreyMode(bool grey)
+{
+  if (grey && !hasGreyLevels()) return false;
+  if (!grey && _grey_shown)
+  {
+    _clearGreyPlanes();
+    _initial = true;
+  }
+  _grey = grey;
+  if (_using_partial_mode) _selectWindow(0);
+  else _setPageArea(0, 0, WIDTH, HEIGHT);
+  return true;
+}
+
+void GxEPD2_32_BW::selectWaveforms(GxEPD2::LutMode full_mode, GxEPD2::LutMode partial_mode)
+{
+  if ((full_mode != GxEPD2::LutNone) && (full_mode < GxEPD2::LutModes)) _full_mode = full_mode;
+  if ((partial_mode != GxEPD2::LutNone) && (partial_mode < GxEPD2::LutModes)) _partial_mode = partial_mode;
+}
+
+void GxEPD2_32_BW::setBusyCallback(void (*busyCallback)(const void*, GxEPD2::BusyPhase), const void* busy_callback_parameter)
+{
+  _busy_callback = busyCallback;
+  _busy_callback_parameter = busy_callback_parameter;
+}
+
+void GxEPD2_32_BW::resetStatistics()
+{
+  GxEPD2_STAT(memset(&_stats, 0, sizeof(_stats)));
+}
+
+bool GxEPD2_32_BW::_nextPage()
+{
+  if (_grey) return _nextPageGrey();
   if (!_using_partial_mode)
   {
     switch (_panel)
@@ -280,72 +441,65 @@ void GxEPD2_32_BW::clearScreen(uint8_t value)
     case GxEPD2::GDEP015OC1:
     case GxEPD2::GDE0213B1:
     case GxEPD2::GDEH029A1:
-      if (_initial)
+      if (_initial || _cleanRefreshDue())
       {
         _Init_Full(_ram_data_entry_mode);
         _setRamEntryWindow(0, 0, WIDTH, HEIGHT, _ram_data_entry_mode);
-        for (int16_t i = 0; i < WIDTH * HEIGHT / 8; i++)
-        {
-          _writeData(value);
-        }
+        _writeDataRepeat(value, WIDTH * HEIGHT / 8);
         _Update_Full();
       }
       else
       {
         _Init_Part(_ram_data_entry_mode);
         _setRamEntryWindow(0, 0, WIDTH, HEIGHT, _ram_data_entry_mode);
-        for (int16_t i = 0; i < WIDTH * HEIGHT / 8; i++)
-        {
-          _writeData(value);
-        }
+        _writeDataRepeat(value, WIDTH * HEIGHT / 8);
         _Update_Part();
       }
       _Init_Part(_ram_data_entry_mode);
       _setRamEntryWindow(0, 0, WIDTH, HEIGHT, _ram_data_entry_mode);
-      for (int16_t i = 0; i < WIDTH * HEIGHT / 8; i++)
-      {
-        _writeData(value);
-      }
+      _writeDataRepeat(value, WIDTH * HEIGHT / 8);
       _Update_Part();
       break;
     case GxEPD2::GDEW027W3:
       _Init_Part(_ram_data_entry_mode);
       _setPartialRamArea(0, 0, WIDTH, HEIGHT);
-      for (int16_t i = 0; i < WIDTH * HEIGHT / 8; i++)
-      {
-        _writeData(value);
-      }
+      _writeDataRepeat(value, WIDTH * HEIGHT / 8);
       _refreshWindow(0, 0, WIDTH, HEIGHT);
-      _waitWhileBusy("clearScreen");
+      _waitWhileBusy("clearScreen", GxEPD2::BusyUpdatePart);
       break;
     case GxEPD2::GDEW042T2:
-      if (_initial)
+      if (_initial || _cleanRefreshDue())
       {
         _Init_Full(_ram_data_entry_mode);
         _writeCommand(0x13);
-        for (int16_t i = 0; i < WIDTH * HEIGHT / 8; i++)
-        {
-          _writeData(value);
-        }
+        _writeDataRepeat(value, WIDTH * HEIGHT / 8);
         _Update_Full();
         _initial = false;
+#if defined(GxEPD2_SHADOW)
+        // the screen is the new data, no partial pass needed; the old data RAM follows with the next partial update
+        memset(_shadow, value, sizeof(_shadow));
+        break;
+#endif
       }
       _Init_Part(_ram_data_entry_mode);
       _writeCommand(0x91); // partial in
+#if defined(GxEPD2_SHADOW)
+      _beginNewData(0, 0, WIDTH, HEIGHT);
+      _writeCommand(0x13);
+      _writeDataRepeat(value, WIDTH * HEIGHT / 8);
+      memset(_shadow, value, sizeof(_shadow));
+      _Update_Part();
+      _syncOldData(0, 0, WIDTH, HEIGHT);
+#else
       _setPartialRamArea(0, 0, WIDTH, HEIGHT);
       _writeCommand(0x13);
-      for (int16_t i = 0; i < WIDTH * HEIGHT / 8; i++)
-      {
-        _writeData(value);
-      }
+      _writeDataRepeat(value, WIDTH * HEIGHT / 8);
       _Update_Part();
       _setPartialRamArea(0, 0, WIDTH, HEIGHT);
       _writeCommand(0x13);
-      for (int16_t i = 0; i < WIDTH * HEIGHT / 8; i++)
-      {
-        _writeData(value);
-      }
+      _writeDataRepeat(value, WIDTH * HEIGHT / 8);
       _Update_Part();
+#endif
       _writeCommand(0x92); // partial out
       break;
     case GxEPD2::GDEW075T8:
@@ -353,17 +507,11 @@ void GxEPD2_32_BW::clearScreen(uint8_t value)
       _writeCommand(0x91); // partial in
       _setPartialRamArea(0, 0, WIDTH, HEIGHT);
       _writeCommand(0x10);
-      for (int16_t i = 0; i < WIDTH * HEIGHT / 8; i++)
-      {
-        _send8pixel(~value);
-      }
+      _send8pixelRepeat(~value, WIDTH * HEIGHT / 8);
       _Update_Part();
       _setPartialRamArea(0, 0, WIDTH, HEIGHT);
       _writeCommand(0x10);
-      for (int16_t i = 0; i < WIDTH * HEIGHT / 8; i++)
-      {
-        _send8pixel(~value);
-      }
+      _send8pixelRepeat(~value, WIDTH * HEIGHT / 8);
       _Update_Part();
       _writeCommand(0x92); // partial out
       break;
@@ -386,31 +534,30 @@ void GxEPD2_32_BW::_writeScreenBuffer(uint8_t value)
     case GxEPD2::GDEH029A1:
       _Init_Part(_ram_data_entry_mode);
       _setRamEntryWindow(0, 0, WIDTH, HEIGHT, _ram_data_entry_mode);
-      for (int16_t i = 0; i < WIDTH * HEIGHT / 8; i++)
-      {
-        _writeData(value);
-      }
+      _writeDataRepeat(value, WIDTH * HEIGHT / 8);
       break;
     case GxEPD2::GDEW027W3:
       _Init_Part(_ram_data_entry_mode);
       _setPartialRamArea(0, 0, WIDTH, HEIGHT);
       _writeCommand(0x13);
-      for (int16_t i = 0; i < WIDTH * HEIGHT / 8; i++)
-      {
-        _writeData(value);
-      }
+      _writeDataRepeat(value, WIDTH * HEIGHT / 8);
       _Update_Part(); // needed!
       break;
     case GxEPD2::GDEW042T2:
       _Init_Part(_ram_data_entry_mode);
       _writeCommand(0x91); // partial in
+#if defined(GxEPD2_SHADOW)
+      _beginNewData(0, 0, WIDTH, HEIGHT);
+#else
       _setPartialRamArea(0, 0, WIDTH, HEIGHT);
+#endif
       _writeCommand(0x13);
-      for (int16_t i = 0; i < WIDTH * HEIGHT / 8; i++)
-      {
-        _writeData(value);
-      }
+      _writeDataRepeat(value, WIDTH * HEIGHT / 8);
       _Update_Part(); // needed!
+#if defined(GxEPD2_SHADOW)
+      memset(_shadow, value, sizeof(_shadow));
+      _syncOldData(0, 0, WIDTH, HEIGHT);
+#endif
       _writeCommand(0x92); // partial out
       break;
     case GxEPD2::GDEW075T8:
@@ -418,10 +565,7 @@ void GxEPD2_32_BW::_writeScreenBuffer(uint8_t value)
       _writeCommand(0x91); // partial in
       _setPartialRamArea(0, 0, WIDTH, HEIGHT);
       _writeCommand(0x10);
-      for (int16_t i = 0; i < WIDTH * HEIGHT / 8; i++)
-      {
-        _send8pixel(~value);
-      }
+      _send8pixelRepeat(~value, WIDTH * HEIGHT / 8);
       _writeCommand(0x92); // partial out
       break;
   }
@@ -456,7 +600,11 @@ void GxEPD2_32_BW::writeImage(const uint8_t bitmap[], int16_t x, int16_t y, int1
     case GxEPD2::GDEW042T2:
       _Init_Part(_ram_data_entry_mode);
       _writeCommand(0x91); // partial in
+#if defined(GxEPD2_SHADOW)
+      _beginNewData(x1, y1, w1, h1);
+#else
       _setPartialRamArea(x1, y1, w1, h1);
+#endif
       _writeCommand(0x13);
       break;
     case GxEPD2::GDEW075T8:
@@ -488,6 +636,9 @@ void GxEPD2_32_BW::writeImage(const uint8_t bitmap[], int16_t x, int16_t y, int1
       if (invert) data = ~data;
       if (_panel == GxEPD2::GDEW075T8) _send8pixel(~data);
       else _writeData(data);
+#if defined(GxEPD2_SHADOW)
+      if (_panel == GxEPD2::GDEW042T2) _shadow[(y1 + i) * _width_bytes + x1 / 8 + j] = data;
+#endif
     }
   }
   switch (_panel)
@@ -506,6 +657,7 @@ void GxEPD2_32_BW::writeImage(const uint8_t bitmap[], int16_t x, int16_t y, int1
 
 void GxEPD2_32_BW::writeImage(const uint8_t* black, const uint8_t* red, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
 {
+  (void) red; // no red on b/w panels
   if (black)
   {
     writeImage(black, x, y, w, h, invert, mirror_y, pgm);
@@ -524,6 +676,164 @@ void GxEPD2_32_BW::drawImage(const uint8_t* black, const uint8_t* red, int16_t x
   refresh(x, y, w, h);
 }
 
+void GxEPD2_32_BW::beginImage(int16_t x, int16_t y, int16_t w, int16_t h, bool bottom_up)
+{
+  _image_active = false;
+  int16_t wb = (w + 7) / 8; // width bytes, rows are padded
+  x -= x % 8; // byte boundary
+  w = wb * 8; // byte boundary
+  int16_t x1 = x < 0 ? 0 : x; // limit
+  int16_t y1 = y < 0 ? 0 : y; // limit
+  int16_t w1 = x + w < WIDTH ? w : WIDTH - x; // limit
+  int16_t h1 = y + h < HEIGHT ? h : HEIGHT - y; // limit
+  int16_t dx = x1 - x;
+  int16_t dy = y1 - y;
+  w1 -= dx;
+  h1 -= dy;
+  if ((w1 <= 0) || (h1 <= 0)) return;
+  _image_wb = wb;
+  _image_dxb = dx / 8;
+  _image_w1b = w1 / 8;
+  _image_dy = dy;
+  _image_h = h;
+  _image_h1 = h1;
+  _image_row = 0;
+  _image_x1 = x1;
+  _image_y1 = y1;
+  _image_bottom_up = bottom_up;
+  // the controller window is set once, rows are appended by the controller address counter;
+  // bottom up: the SSD16xx controllers count y down, the others get a band window per writeImageRows()
+  switch (_panel)
+  {
+    case GxEPD2::GDEP015OC1:
+    case GxEPD2::GDE0213B1:
+    case GxEPD2::GDEH029A1:
+      _Init_Part(_ram_data_entry_mode);
+      _setRamEntryWindow(x1, y1, w1, h1, bottom_up ? _ram_data_entry_mode ^ 0x02 : _ram_data_entry_mode);
+      break;
+    case GxEPD2::GDEW027W3:
+      _Init_Part(_ram_data_entry_mode);
+      if (!bottom_up) _setPartialRamArea(x1, y1, w1, h1);
+      break;
+    case GxEPD2::GDEW042T2:
+      _Init_Part(_ram_data_entry_mode);
+      _writeCommand(0x91); // partial in
+      if (bottom_up) break;
+#if defined(GxEPD2_SHADOW)
+      _beginNewData(x1, y1, w1, h1);
+#else
+      _setPartialRamArea(x1, y1, w1, h1);
+#endif
+      _writeCommand(0x13);
+      break;
+    case GxEPD2::GDEW075T8:
+      _Init_Part(_ram_data_entry_mode);
+      _writeCommand(0x91); // partial in
+      if (bottom_up) break;
+      _setPartialRamArea(x1, y1, w1, h1);
+      _writeCommand(0x10);
+      break;
+  }
+  _image_active = true;
+}
+
+void GxEPD2_32_BW::writeImageRows(const uint8_t bitmap[], int16_t rows, bool invert, bool pgm)
+{
+  if (!_image_active) return;
+  int16_t first = _image_row;
+  _image_row += rows;
+  if (_image_bottom_up && (_panel >= GxEPD2::GDEW027W3))
+  {
+    // image rows of this call, top to bottom, inside the clipped image
+    int16_t lo = gx_int16_max(_image_h - first - rows, _image_dy);
+    int16_t hi = gx_int16_min(_image_h - first, _image_dy + _image_h1);
+    if (hi <= lo) return;
+#if defined(GxEPD2_SHADOW)
+    if (_panel == GxEPD2::GDEW042T2) _beginNewData(_image_x1, _image_y1 + lo - _image_dy, _image_w1b * 8, hi - lo);
+    else
+#endif
+      _setPartialRamArea(_image_x1, _image_y1 + lo - _image_dy, _image_w1b * 8, hi - lo);
+    if (_panel == GxEPD2::GDEW042T2) _writeCommand(0x13);
+    if (_panel == GxEPD2::GDEW075T8) _writeCommand(0x10);
+    // rows were passed bottom first
+    for (int16_t r = lo; r < hi; r++)
+    {
+      _writeImageRow(bitmap + (_image_h - 1 - first - r) * _image_wb, _image_y1 + r - _image_dy, invert, pgm);
+    }
+    return;
+  }
+  for (int16_t i = 0; i < rows; i++, bitmap += _image_wb)
+  {
+    int16_t r = _image_bottom_up ? _image_h - 1 - (first + i) : first + i;
+    if ((r < _image_dy) || (r >= _image_dy + _image_h1)) continue; // clipped
+    _writeImageRow(bitmap, _image_y1 + r - _image_dy, invert, pgm);
+  }
+}
+
+void GxEPD2_32_BW::writeImageRows(const uint8_t* black, const uint8_t* red, int16_t rows, bool invert, bool pgm)
+{
+  (void) red; // no red on b/w panels
+  writeImageRows(black, rows, invert, pgm);
+}
+
+void GxEPD2_32_BW::_writeImageRow(const uint8_t* row, int16_t y, bool invert, bool pgm)
+{
+  row += _image_dxb;
+#if defined(GxEPD2_SHADOW)
+  uint8_t* shadow = (_panel == GxEPD2::GDEW042T2) ? _shadow + y * _width_bytes + _image_x1 / 8 : 0;
+#else
+  (void) y; // row of the shadow
+#endif
+  if (!invert && !pgm && (_panel != GxEPD2::GDEW075T8))
+  {
+    _writeData(row, _image_w1b);
+#if defined(GxEPD2_SHADOW)
+    if (shadow) memcpy(shadow, row, _image_w1b);
+#endif
+    return;
+  }
+  for (int16_t j = 0; j < _image_w1b; j++)
+  {
+    uint8_t data;
+    if (pgm)
+    {
+#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
+      data = pgm_read_byte(&row[j]);
+#else
+      data = row[j];
+#endif
+    }
+    else
+    {
+      data = row[j];
+    }
+    if (invert) data = ~data;
+    if (_panel == GxEPD2::GDEW075T8) _send8pixel(~data);
+    else _writeData(data);
+#if defined(GxEPD2_SHADOW)
+    if (shadow) shadow[j] = data;
+#endif
+  }
+}
+
+void GxEPD2_32_BW::endImage()
+{
+  if (!_image_active) return;
+  switch (_panel)
+  {
+    case GxEPD2::GDEP015OC1:
+    case GxEPD2::GDE0213B1:
+    case GxEPD2::GDEH029A1:
+    case GxEPD2::GDEW027W3:
+      break;
+    case GxEPD2::GDEW042T2:
+    case GxEPD2::GDEW075T8:
+      _writeCommand(0x92); // partial out
+      break;
+  }
+  _image_active = false;
+}
+
 void GxEPD2_32_BW::refresh(bool partial_update_mode)
 {
   if (partial_update_mode) refresh(0, 0, WIDTH, HEIGHT);
@@ -540,6 +850,11 @@ void GxEPD2_32_BW::refresh(int16_t x, int16_t y, int16_t w, int16_t h)
   int16_t h1 = y + h < HEIGHT ? h : HEIGHT - y; // limit
   w1 -= x1 - x;
   h1 -= y1 - y;
+  if (_grey_shown)
+  {
+    _refreshAfterGrey();
+    return;
+  }
   switch (_panel)
   {
     case GxEPD2::GDEP015OC1:
@@ -547,18 +862,34 @@ void GxEPD2_32_BW::refresh(int16_t x, int16_t y, int16_t w, int16_t h)
     case GxEPD2::GDEH029A1:
       _Init_Part(_ram_data_entry_mode);
       _setRamEntryWindow(x1, y1, w1, h1, _ram_data_entry_mode);
-      _Update_Part();
+      if (_cleanRefreshDue()) _Update_Clean(x1, y1, w1, h1);
+      else
+      {
+        _Update_Part();
+        _countPartialUpdate(x1, y1, w1, h1);
+      }
       break;
     case GxEPD2::GDEW027W3:
       _refreshWindow(x1, y1, w1, h1);
-      _waitWhileBusy("refresh");
+      _waitWhileBusy("refresh", GxEPD2::BusyUpdatePart);
       break;
     case GxEPD2::GDEW042T2:
+#if defined(GxEPD2_SHADOW)
+      _Init_Part(_ram_data_entry_mode);
+      _writeCommand(0x91); // partial in
+      _refreshPart42(x1, y1, w1, h1);
+      break;
+#endif
     case GxEPD2::GDEW075T8:
       _Init_Part(_ram_data_entry_mode);
       _writeCommand(0x91); // partial in
       _setPartialRamArea(x1, y1, w1, h1);
-      _Update_Part();
+      if (_cleanRefreshDue()) _Update_Clean(x1, y1, w1, h1);
+      else
+      {
+        _Update_Part();
+        _countPartialUpdate(x1, y1, w1, h1);
+      }
       break;
   }
 }
@@ -566,12 +897,9 @@ void GxEPD2_32_BW::refresh(int16_t x, int16_t y, int16_t w, int16_t h)
 bool GxEPD2_32_BW::_nextPageFull()
 {
   uint16_t page_ys = _current_page * _page_height;
-  uint16_t bytes = (_current_page < (_pages - 1) ? _page_height : HEIGHT - page_ys) * _width_bytes;
-  for (uint16_t idx = 0; idx < bytes; idx++)
-  {
-    uint8_t data = (idx < sizeof(_buffer)) ? _buffer[idx] : 0x00;
-    _writeData(~data);
-  }
+  uint16_t bytes = (_current_page < (_pages - 1) ? _page_height : _area_height - page_ys) * _area_width_bytes;
+  const uint8_t* page = _page_buffer; // still valid after the update, nothing is drawn
+  _sendPage(bytes);
   _current_page++;
   if (_current_page < _pages)
   {
@@ -586,7 +914,9 @@ bool GxEPD2_32_BW::_nextPageFull()
     _current_page = 0;
     _Init_Part(_ram_data_entry_mode);
     _writeCommand(0x24);
-    return true;
+    if (_pages > 1) return true;
+    // one page holds the screen: resend it, no need to draw it again
+    _transmitPage(this, page, bytes);
   }
   _PowerOff();
   _current_page = -1;
@@ -596,44 +926,27 @@ bool GxEPD2_32_BW::_nextPageFull()
 bool GxEPD2_32_BW::_nextPagePart()
 {
   uint16_t page_ys = _current_page * _page_height;
-  uint16_t page_ye = _current_page < (_pages - 1) ? page_ys + _page_height : HEIGHT;
-  uint16_t dest_ys = gx_uint16_max(_pw_y, page_ys);
-  uint16_t dest_ye = gx_uint16_min(_pw_y + _pw_h, page_ye);
-  if (_reverse)
-  {
-    dest_ys = gx_uint16_max(HEIGHT - _pw_y - _pw_h, page_ys);
-    dest_ye = gx_uint16_min(HEIGHT - _pw_y, page_ye);
-  }
-  if (dest_ye > dest_ys)
-  {
-    uint16_t xs_d8 = _pw_x / 8;
-    uint16_t xe_d8 = (_pw_x + _pw_w + 7) / 8;
-    uint16_t ys = dest_ys - page_ys;
-    uint16_t ye = dest_ye - page_ys;
-    for (uint16_t y = ys; y < ye; y++)
-    {
-      for (uint16_t x = xs_d8; x < xe_d8; x++)
-      {
-        uint16_t idx = x + y * _width_bytes;
-        uint8_t data = (idx < sizeof(_buffer)) ? _buffer[idx] : 0x00;
-        _writeData(~data);
-      }
-    }
-  }
+  uint16_t bytes = (_current_page < (_pages - 1) ? _page_height : _area_height - page_ys) * _area_width_bytes;
+  const uint8_t* page = _page_buffer; // still valid after the update, nothing is drawn
+  _sendPage(bytes);
   _current_page++;
   if (_current_page < _pages)
   {
     fillScreen(GxEPD_WHITE);
     return true;
   }
+  if (_nextWindow()) return true;
   if (!_second_phase)
   {
-    _Update_Part();
+    _refreshWindows();
     delay(200);
     _second_phase = true;
     _current_page = 0;
-    _setRamEntryWindow(_pw_x, _pw_y, _pw_w, _pw_h, _ram_data_entry_mode); // needed!
-    return true;
+    _selectWindow(0);
+    _setWindowRamArea(); // needed!
+    if ((_pages > 1) || (_window_count > 1)) return true;
+    // one page holds the window: resend it, no need to draw it again
+    _transmitPage(this, page, bytes);
   }
   delay(200);
   //_PowerOff();
@@ -644,12 +957,8 @@ bool GxEPD2_32_BW::_nextPagePart()
 bool GxEPD2_32_BW::_nextPageFull27()
 {
   uint16_t page_ys = _current_page * _page_height;
-  uint16_t bytes = (_current_page < (_pages - 1) ? _page_height : HEIGHT - page_ys) * _width_bytes;
-  for (uint16_t idx = 0; idx < bytes; idx++)
-  {
-    uint8_t data = (idx < sizeof(_buffer)) ? _buffer[idx] : 0x00;
-    _writeData(~data);
-  }
+  uint16_t bytes = (_current_page < (_pages - 1) ? _page_height : _area_height - page_ys) * _area_width_bytes;
+  _sendPage(bytes);
   _current_page++;
   if (_current_page < _pages)
   {
@@ -665,33 +974,16 @@ bool GxEPD2_32_BW::_nextPageFull27()
 bool GxEPD2_32_BW::_nextPagePart27()
 {
   uint16_t page_ys = _current_page * _page_height;
-  uint16_t page_ye = _current_page < (_pages - 1) ? page_ys + _page_height : HEIGHT;
-  uint16_t dest_ys = gx_uint16_max(_pw_y, page_ys);
-  uint16_t dest_ye = gx_uint16_min(_pw_y + _pw_h, page_ye);
-  if (dest_ye > dest_ys)
-  {
-    uint16_t xs_d8 = _pw_x / 8; // byte boundary
-    uint16_t xe_d8 = ((_pw_x + _pw_w - 1) | 0x0007) / 8; // byte boundary inclusive (last byte)
-    uint16_t ys = dest_ys - page_ys;
-    uint16_t ye = dest_ye - page_ys; // exclusive
-    for (uint16_t y = ys; y < ye; y++)
-    {
-      for (uint16_t x = xs_d8; x <= xe_d8; x++)
-      {
-        uint16_t idx = x + y * _width_bytes;
-        uint8_t data = (idx < sizeof(_buffer)) ? _buffer[idx] : 0x00;
-        _writeData(~data);
-      }
-    }
-  }
+  uint16_t bytes = (_current_page < (_pages - 1) ? _page_height : _area_height - page_ys) * _area_width_bytes;
+  _sendPage(bytes);
   _current_page++;
   if (_current_page < _pages)
   {
     fillScreen(GxEPD_WHITE);
     return true;
   }
-  _refreshWindow(_pw_x, _pw_y, _pw_w, _pw_h);
-  _waitWhileBusy("_nextPage27");
+  if (_nextWindow()) return true;
+  _refreshWindows();
   delay(500); // don't stress this display
   //_PowerOff();
   _current_page = -1;
@@ -701,12 +993,11 @@ bool GxEPD2_32_BW::_nextPagePart27()
 bool GxEPD2_32_BW::_nextPageFull42()
 {
   uint16_t page_ys = _current_page * _page_height;
-  uint16_t bytes = (_current_page < (_pages - 1) ? _page_height : HEIGHT - page_ys) * _width_bytes;
-  for (uint16_t idx = 0; idx < bytes; idx++)
-  {
-    uint8_t data = (idx < sizeof(_buffer)) ? _buffer[idx] : 0x00;
-    _writeData(~data);
-  }
+  uint16_t bytes = (_current_page < (_pages - 1) ? _page_height : _area_height - page_ys) * _area_width_bytes;
+#if defined(GxEPD2_SHADOW)
+  for (uint16_t i = 0; i < bytes; i++) _shadow[page_ys * _width_bytes + i] = ~_page_buffer[i];
+#endif
+  _sendPage(bytes);
   _current_page++;
   if (_current_page < _pages)
   {
@@ -731,40 +1022,41 @@ bool GxEPD2_32_BW::_nextPageFull42()
 bool GxEPD2_32_BW::_nextPagePart42()
 {
   uint16_t page_ys = _current_page * _page_height;
-  uint16_t page_ye = _current_page < (_pages - 1) ? page_ys + _page_height : HEIGHT;
-  uint16_t dest_ys = gx_uint16_max(_pw_y, page_ys);
-  uint16_t dest_ye = gx_uint16_min(_pw_y + _pw_h, page_ye);
-  if (dest_ye > dest_ys)
-  {
-    uint16_t xe_d8 = ((_pw_x + _pw_w - 1) | 0x0007) / 8; // byte boundary inclusive (last byte)
-    uint16_t xs_d8 = _pw_x / 8; // byte boundary
-    uint16_t ys = dest_ys - page_ys;
-    uint16_t ye = dest_ye - page_ys; // exclusive
-    for (uint16_t y = ys; y < ye; y++)
-    {
-      for (uint16_t x = xs_d8; x <= xe_d8; x++)
-      {
-        uint16_t idx = x + y * _width_bytes;
-        uint8_t data = (idx < sizeof(_buffer)) ? _buffer[idx] : 0x00;
-        _writeData(~data);
-      }
-    }
-  }
+#if defined(GxEPD2_SHADOW)
+  _writePageChanges(page_ys, _current_page < (_pages - 1) ? _page_height : _area_height - page_ys);
+#else
+  uint16_t bytes = (_current_page < (_pages - 1) ? _page_height : _area_height - page_ys) * _area_width_bytes;
+  _sendPage(bytes);
+#endif
   _current_page++;
   if (_current_page < _pages)
   {
     fillScreen(GxEPD_WHITE);
     return true;
   }
+  if (_nextWindow()) return true;
+#if defined(GxEPD2_SHADOW)
+  // old data RAM is in sync, no second phase; only changed bytes were sent, nothing changed needs no refresh
+  if (_grey_shown) _refreshAfterGrey();
+  else if (_pending_xe > _pending_x) _refreshPart42(_pending_x, _pending_y, _pending_xe - _pending_x, _pending_ye - _pending_y);
+#else
   if (!_second_phase)
   {
-    _Update_Part();
+    if (_grey_shown)
+    {
+      _refreshAfterGrey();
+      _Init_Part(_ram_data_entry_mode);
+      _writeCommand(0x91); // partial in
+    }
+    else _refreshWindows();
     _current_page = 0;
     _second_phase = true;
     fillScreen(GxEPD_WHITE);
-    _writeCommand(0x13);
+    _selectWindow(0);
+    _setWindowRamArea();
     return true;
   }
+#endif
   _writeCommand(0x92); // partial out
   _current_page = -1;
   return false;
@@ -773,12 +1065,8 @@ bool GxEPD2_32_BW::_nextPagePart42()
 bool GxEPD2_32_BW::_nextPageFull75()
 {
   uint16_t page_ys = _current_page * _page_height;
-  uint16_t bytes = (_current_page < (_pages - 1) ? _page_height : HEIGHT - page_ys) * _width_bytes;
-  for (uint16_t idx = 0; idx < bytes; idx++)
-  {
-    uint8_t data = (idx < sizeof(_buffer)) ? _buffer[idx] : 0x00;
-    _send8pixel(data);
-  }
+  uint16_t bytes = (_current_page < (_pages - 1) ? _page_height : _area_height - page_ys) * _area_width_bytes;
+  _sendPage(bytes);
   _current_page++;
   if (_current_page < _pages)
   {
@@ -794,37 +1082,251 @@ bool GxEPD2_32_BW::_nextPageFull75()
 bool GxEPD2_32_BW::_nextPagePart75()
 {
   uint16_t page_ys = _current_page * _page_height;
-  uint16_t page_ye = _current_page < (_pages - 1) ? page_ys + _page_height : HEIGHT;
-  uint16_t dest_ys = gx_uint16_max(_pw_y, page_ys);
-  uint16_t dest_ye = gx_uint16_min(_pw_y + _pw_h, page_ye);
-  if (dest_ye > dest_ys)
-  {
-    uint16_t xe_d8 = ((_pw_x + _pw_w - 1) | 0x0007) / 8; // byte boundary inclusive (last byte)
-    uint16_t xs_d8 = _pw_x / 8; // byte boundary
-    uint16_t ys = dest_ys - page_ys;
-    uint16_t ye = dest_ye - page_ys; // exclusive
-    for (uint16_t y = ys; y < ye; y++)
-    {
-      for (uint16_t x = xs_d8; x <= xe_d8; x++)
-      {
-        uint16_t idx = x + y * _width_bytes;
-        uint8_t data = (idx < sizeof(_buffer)) ? _buffer[idx] : 0x00;
-        _send8pixel(data);
-      }
-    }
-  }
+  uint16_t bytes = (_current_page < (_pages - 1) ? _page_height : _area_height - page_ys) * _area_width_bytes;
+  _sendPage(bytes);
   _current_page++;
   if (_current_page < _pages)
   {
     fillScreen(GxEPD_WHITE);
     return true;
   }
-  _Update_Part();
+  if (_nextWindow()) return true;
+  _refreshWindows();
   _writeCommand(0x92); // partial out
   _current_page = -1;
   return false;
 }
 
+bool GxEPD2_32_BW::_nextPageGrey()
+{
+  uint16_t page_ys = _current_page * _page_height;
+  uint16_t rows = _current_page < (_pages - 1) ? _page_height : _area_height - page_ys;
+  uint16_t bytes = rows * _area_width_bytes;
+#if defined(GxEPD2_PIPELINE)
+  _pipeline.wait(0); // grey pages are sent from here, with commands
+#endif
+  _setPartialRamArea(0, page_ys, WIDTH, rows);
+  _writeGreyPlane(0x10, 1, bytes);
+  _setPartialRamArea(0, page_ys, WIDTH, rows);
+  _writeGreyPlane(0x13, 0, bytes);
+  _current_page++;
+  if (_current_page < _pages)
+  {
+    return true;
+  }
+  _writeCommand(0x92); // partial out
+  _Update_Full();
+  delay(200);
+  _PowerOff();
+  _initial = false;
+  // both planes and, with GxEPD2_SHADOW, the shadow are no b/w picture until setGreyMode(false) clears them
+  _grey_shown = true;
+  _current_page = -1;
+  return false;
+}
+
+void GxEPD2_32_BW::_writeGreyPlane(uint8_t command, uint8_t bit, uint16_t bytes)
+{
+  // one bit of the level per pixel, 8 pixels from 2 buffer bytes, 1 is white
+  _writeCommand(command);
+  for (uint16_t idx = 0; idx < bytes; idx++)
+  {
+    uint8_t d = 0;
+    for (uint8_t j = 0; j < 2; j++)
+    {
+      uint8_t v = _page_buffer[2 * idx + j] >> bit; // bits at 6, 4, 2, 0
+      d = (d << 4) | ((v >> 3) & 0x08) | ((v >> 2) & 0x04) | ((v >> 1) & 0x02) | (v & 0x01);
+    }
+    _writeData(~d);
+  }
+}
+
+void GxEPD2_32_BW::_clearGreyPlanes()
+{
+  // white, the known content outside the windows of the next update
+  _writeCommand(0x92); // partial out, the whole RAM
+  _writeCommand(0x10);
+  _writeDataRepeat(0xFF, WIDTH * HEIGHT / 8);
+  _writeCommand(0x13);
+  _writeDataRepeat(0xFF, WIDTH * HEIGHT / 8);
+#if defined(GxEPD2_SHADOW)
+  memset(_shadow, 0xFF, sizeof(_shadow));
+  _old_synced = true;
+  _pending_x = _pending_y = _pending_xe = _pending_ye = 0;
+#endif
+}
+
+void GxEPD2_32_BW::_refreshAfterGrey()
+{
+  // a partial refresh leaves grey pixels that are not new data; the whole new data RAM, with the full waveform
+  _writeCommand(0x92); // partial out
+  _Init_Full(_ram_data_entry_mode);
+  _Update_Full();
+  _initial = false;
+}
+
+#if defined(GxEPD2_SHADOW)
+void GxEPD2_32_BW::_prepareOldData()
+{
+  // after a full refresh the screen is the shadow; the old data RAM is written once, before new data
+  if (_old_synced) return;
+  _setPartialRamArea(0, 0, WIDTH, HEIGHT);
+  _writeCommand(0x10);
+  _writeData(_shadow, sizeof(_shadow));
+  _old_synced = true;
+}
+
+void GxEPD2_32_BW::_beginNewData(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+  // the window for new data, which is pending until refreshed
+  _prepareOldData();
+  uint16_t xs = x & 0xFFF8, xe = (x + w + 7) & 0xFFF8, ye = y + h;
+  if (_pending_xe <= _pending_x)
+  {
+    _pending_x = xs;
+    _pending_y = y;
+    _pending_xe = xe;
+    _pending_ye = ye;
+  }
+  else
+  {
+    _pending_x = gx_uint16_min(_pending_x, xs);
+    _pending_y = gx_uint16_min(_pending_y, y);
+    _pending_xe = gx_uint16_max(_pending_xe, xe);
+    _pending_ye = gx_uint16_max(_pending_ye, ye);
+  }
+  _setPartialRamArea(x, y, w, h);
+}
+
+void GxEPD2_32_BW::_writePageChanges(uint16_t page_ys, uint16_t rows)
+{
+  // the bytes of the page that differ from the shadow, as one span of rows and columns; the page becomes the shadow
+#if defined(GxEPD2_PIPELINE)
+  _pipeline.wait(0); // sent from here, with commands
+#endif
+  uint16_t y = _area_y + page_ys;
+  uint16_t bs = _area_width_bytes, be = 0, rs = rows, re = 0;
+  for (uint16_t r = 0; r < rows; r++)
+  {
+    const uint8_t* shadow = _shadow + (y + r) * _width_bytes + _area_x / 8;
+    const uint8_t* page = _page_buffer + r * _area_width_bytes;
+    for (uint16_t b = 0; b < _area_width_bytes; b++)
+    {
+      if (shadow[b] == uint8_t(~page[b])) continue;
+      bs = gx_uint16_min(bs, b);
+      be = gx_uint16_max(be, b + 1);
+      rs = gx_uint16_min(rs, r);
+      re = r + 1;
+    }
+  }
+  if (re == 0) return; // unchanged
+  _beginNewData(_area_x + bs * 8, y + rs, (be - bs) * 8, re - rs);
+  _writeCommand(0x13);
+  for (uint16_t r = rs; r < re; r++)
+  {
+    uint8_t* shadow = _shadow + (y + r) * _width_bytes + _area_x / 8;
+    const uint8_t* page = _page_buffer + r * _area_width_bytes;
+    for (uint16_t b = bs; b < be; b++)
+    {
+      shadow[b] = ~page[b];
+      _writeData(shadow[b]);
+    }
+  }
+}
+
+void GxEPD2_32_BW::_refreshPart42(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+  // partial refresh, in partial mode; then the refreshed new data goes to the old data RAM
+  _setPartialRamArea(x, y, w, h);
+  if (_cleanRefreshDue()) _Update_Clean(x, y, w, h);
+  else
+  {
+    _Update_Part();
+    _countPartialUpdate(x, y, w, h);
+    _syncOldData(x, y, w, h);
+  }
+}
+
+void GxEPD2_32_BW::_syncOldData(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+  // the refreshed part of the pending area, from the shadow; the controller doesn't copy new to old data
+  uint16_t xs = gx_uint16_max(x & 0xFFF8, _pending_x), ys = gx_uint16_max(y, _pending_y);
+  uint16_t xe = gx_uint16_min(x + w, _pending_xe), ye = gx_uint16_min(y + h, _pending_ye);
+  if ((xs < xe) && (ys < ye))
+  {
+    uint16_t xb = xs / 8, wb = (xe + 7) / 8 - xb;
+    _setPartialRamArea(xs, ys, xe - xs, ye - ys);
+    _writeCommand(0x10);
+    for (uint16_t r = ys; r < ye; r++)
+    {
+      _writeData(_shadow + r * _width_bytes + xb, wb);
+    }
+  }
+  if ((x <= _pending_x) && (y <= _pending_y) && (x + w >= _pending_xe) && (y + h >= _pending_ye))
+  {
+    _pending_x = _pending_y = _pending_xe = _pending_ye = 0;
+  }
+}
+#endif
+
+void GxEPD2_32_BW::_setBufferSize(uint16_t size)
+{
+#if defined(GxEPD2_PIPELINE)
+  _page_buffer_size = size / 2; // one half is drawn while the other is sent
+#else
+  _page_buffer_size = size;
+#endif
+  _setPageArea(0, 0, WIDTH, HEIGHT);
+}
+
+bool GxEPD2_32_BW::_borrowBuffer()
+{
+#if defined(GxEPD2_BUFFER_ARENA)
+  _buffer = _arena ? _arena->borrow(this) : 0;
+  _page_buffer = _buffer;
+  if (!_buffer)
+  {
+    Serial.println("firstPage : page buffer arena not set or in use");
+    return false;
+  }
+#endif
+  return true;
+}
+
+void GxEPD2_32_BW::_releaseBuffer()
+{
+#if defined(GxEPD2_BUFFER_ARENA)
+  if (_arena) _arena->release(this);
+  _buffer = 0;
+  _page_buffer = 0;
+#endif
+}
+
+void GxEPD2_32_BW::_sendPage(uint16_t bytes)
+{
+#if defined(GxEPD2_PIPELINE)
+  _pipeline.send(_page_buffer, bytes);
+  // draw the next page into the other half, once its previous page is sent
+  _page_buffer = (_page_buffer == _buffer) ? _buffer + _page_buffer_size : _buffer;
+  _pipeline.wait(1);
+  // commands follow the last page of a window
+  if (_current_page + 1 >= _pages) _pipeline.wait(0);
+#else
+  _transmitPage(this, _page_buffer, bytes);
+#endif
+}
+
+void GxEPD2_32_BW::_transmitPage(void* pv, const uint8_t* data, uint16_t bytes)
+{
+  GxEPD2_32_BW* p = static_cast<GxEPD2_32_BW*>(pv);
+  for (uint16_t idx = 0; idx < bytes; idx++)
+  {
+    uint8_t d = (idx < p->_page_buffer_size) ? data[idx] : 0x00;
+    if (p->_panel == GxEPD2::GDEW075T8) p->_send8pixel(d);
+    else p->_writeData(~d);
+  }
+}
+
 void GxEPD2_32_BW::_send8pixel(uint8_t data)
 {
   for (uint8_t j = 0; j < 8; j++)
@@ -839,57 +1341,138 @@ void GxEPD2_32_BW::_send8pixel(uint8_t data)
   }
 }
 
+void GxEPD2_32_BW::_send8pixelRepeat(uint8_t data, uint16_t count)
+{
+  uint8_t pattern[4];
+  for (uint8_t j = 0; j < 4; j++)
+  {
+    uint8_t t = data & 0x80 ? 0x00 : 0x03;
+    t <<= 4;
+    data <<= 1;
+    t |= data & 0x80 ? 0x00 : 0x03;
+    data <<= 1;
+    pattern[j] = t;
+  }
+  _writeDataRepeat(pattern, sizeof(pattern), count);
+}
+
+uint8_t GxEPD2_32_BW::_dummyLines(uint8_t lines)
+{
+  // frame time is (gate lines + dummy lines) * gate time, register is 7 bits
+  uint16_t scaled = uint32_t(HEIGHT + lines) * _lut_scale / 100 - HEIGHT;
+  return gx_uint16_min(scaled, 0x7F);
+}
+
+void GxEPD2_32_BW::_writeLut(const uint8_t* lut, uint8_t n, uint8_t offset)
+{
+  // rows of level select, 4 phase frame counts, repeat count, after offset bytes; frame counts scaled
+  uint8_t buf[64];
+  if ((_lut_scale == 100) || (n > sizeof(buf)))
+  {
+    _writeData(lut, n);
+    return;
+  }
+  for (uint8_t i = 0; i < n; i++)
+  {
+    uint8_t column = (i - offset) % 6;
+    bool frames = (i >= offset) && (i - offset < 7 * 6) && (column >= 1) && (column <= 4);
+    buf[i] = frames ? gx_uint16_min(uint16_t(lut[i]) * _lut_scale / 100, 0xFF) : lut[i];
+  }
+  _writeData(buf, n);
+}
+
 void GxEPD2_32_BW::_writeCommand(uint8_t c)
 {
+  GxEPD2_TIME(uint32_t start = micros());
   if (_dc >= 0) digitalWrite(_dc, LOW);
   if (_cs >= 0) digitalWrite(_cs, LOW);
   SPI.transfer(c);
   if (_cs >= 0) digitalWrite(_cs, HIGH);
   if (_dc >= 0) digitalWrite(_dc, HIGH);
+  GxEPD2_STAT(_stats.spi_us += micros() - start; _stats.command_bytes++; _stats.cs_toggles += (_cs >= 0));
+  GxEPD2_TRC(_trace.command(c, start, micros()));
 }
 
 void GxEPD2_32_BW::_writeData(uint8_t d)
 {
+  GxEPD2_TIME(uint32_t start = micros());
   if (_cs >= 0) digitalWrite(_cs, LOW);
   SPI.transfer(d);
   if (_cs >= 0) digitalWrite(_cs, HIGH);
+  GxEPD2_STAT(_stats.spi_us += micros() - start; _stats.data_bytes++; _stats.cs_toggles += (_cs >= 0));
+  GxEPD2_TRC(_trace.data(d, 1, start, micros()));
 }
 
 void GxEPD2_32_BW::_writeData(const uint8_t* data, uint16_t n)
 {
+  GxEPD2_TIME(uint32_t start = micros());
   if (_cs >= 0) digitalWrite(_cs, LOW);
-  for (uint8_t i = 0; i < n; i++)
+  for (uint16_t i = 0; i < n; i++)
   {
     SPI.transfer(*data++);
   }
   if (_cs >= 0) digitalWrite(_cs, HIGH);
+  GxEPD2_STAT(_stats.spi_us += micros() - start; _stats.data_bytes += n; _stats.cs_toggles += (_cs >= 0));
+  GxEPD2_TRC(_trace.data((n > 0) ? data[-n] : 0, n, start, micros()));
+}
+
+void GxEPD2_32_BW::_writeDataRepeat(const uint8_t* pattern, uint8_t len, uint16_t count)
+{
+  // count copies of pattern in one transfer
+  GxEPD2_TIME(uint32_t start = micros());
+  if (_cs >= 0) digitalWrite(_cs, LOW);
+#if defined(ESP8266) || defined(ESP32)
+  SPI.writePattern(pattern, len, count);
+#else
+  for (uint16_t i = 0; i < count; i++)
+  {
+    for (uint8_t j = 0; j < len; j++)
+    {
+      SPI.transfer(pattern[j]);
+    }
+  }
+#endif
+  if (_cs >= 0) digitalWrite(_cs, HIGH);
+  GxEPD2_STAT(_stats.spi_us += micros() - start; _stats.data_bytes += uint32_t(len) * count; _stats.cs_toggles += (_cs >= 0));
+  GxEPD2_TRC(_trace.data(pattern[0], uint32_t(len) * count, start, micros()));
+}
+
+void GxEPD2_32_BW::_writeDataRepeat(uint8_t value, uint16_t count)
+{
+  _writeDataRepeat(&value, 1, count);
 }
 
 void GxEPD2_32_BW::_writeCommandData(const uint8_t* pCommandData, uint8_t datalen)
 {
+  GxEPD2_TIME(uint32_t start = micros());
   if (_dc >= 0) digitalWrite(_dc, LOW);
   if (_cs >= 0) digitalWrite(_cs, LOW);
   SPI.transfer(*pCommandData++);
   if (_dc >= 0) digitalWrite(_dc, HIGH);
+  GxEPD2_TRC(_trace.command(pCommandData[-1], start, micros()); uint32_t data_start = micros());
   for (uint8_t i = 0; i < datalen - 1; i++)  // sub the command
   {
     SPI.transfer(*pCommandData++);
   }
   if (_cs >= 0) digitalWrite(_cs, HIGH);
+  GxEPD2_STAT(_stats.spi_us += micros() - start; _stats.command_bytes++; _stats.data_bytes += datalen - 1; _stats.cs_toggles += (_cs >= 0));
+  GxEPD2_TRC(_trace.data(pCommandData[1 - datalen], datalen - 1, data_start, micros()));
 }
 
-void GxEPD2_32_BW::_waitWhileBusy(const char* comment)
+void GxEPD2_32_BW::_waitWhileBusy(const char* comment, GxEPD2::BusyPhase phase)
 {
   unsigned long start = micros();
   while (1)
   {
     if (digitalRead(_busy) != _busy_active_level) break;
-    delay(1);
     if (micros() - start > 10000000)
     {
       Serial.println("Busy Timeout!");
       break;
     }
+    // the pin is read again after the callback, which may take long
+    if (_busy_callback) _busy_callback(_busy_callback_parameter, phase);
+    else delay(1);
   }
   if (comment)
   {
@@ -900,7 +1483,10 @@ void GxEPD2_32_BW::_waitWhileBusy(const char* comment)
     Serial.println(elapsed);
 #endif
   }
+  GxEPD2_STAT(_stats.busy_us[phase] += micros() - start);
+  GxEPD2_TRC(_trace.busy(phase, start, micros()));
   (void) start;
+  (void) phase;
 }
 
 void GxEPD2_32_BW::_setRamEntryWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t em)
@@ -988,16 +1574,119 @@ void GxEPD2_32_BW::_setPartialRamArea(uint16_t x, uint16_t y, uint16_t w, uint16
 void GxEPD2_32_BW::_refreshWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
 {
   w = (w + 7 + (x % 8)) & 0xfff8; // byte boundary exclusive (round up)
-  h = gx_uint16_min(h, 256); // strange controller error
-  _writeCommand(0x16);
-  _writeData(x >> 8);
-  _writeData(x & 0xf8);
-  _writeData(y >> 8);
-  _writeData(y & 0xff);
-  _writeData(w >> 8);
-  _writeData(w & 0xf8);
-  _writeData(h >> 8);
-  _writeData(h & 0xff);
+  // at most 256 rows per refresh (strange controller error), taller windows are refreshed in stacked stripes;
+  // the controller takes no commands while BUSY, so each stripe waits for the previous, the caller waits for the last
+  while (h > 0)
+  {
+    uint16_t hs = gx_uint16_min(h, 256);
+    _writeCommand(0x16);
+    _writeData(x >> 8);
+    _writeData(x & 0xf8);
+    _writeData(y >> 8);
+    _writeData(y & 0xff);
+    _writeData(w >> 8);
+    _writeData(w & 0xf8);
+    _writeData(hs >> 8);
+    _writeData(hs & 0xff);
+    y += hs;
+    h -= hs;
+    if (h > 0) _waitWhileBusy("_refreshWindow", GxEPD2::BusyUpdatePart);
+  }
+}
+
+void GxEPD2_32_BW::_selectWindow(uint8_t index)
+{
+  _window_index = index;
+  _pw_x = _windows[index].x;
+  _pw_y = _windows[index].y;
+  _pw_w = _windows[index].w;
+  _pw_h = _windows[index].h;
+  // flip y for y-decrement mode
+  _setPageArea(_pw_x, _reverse ? HEIGHT - _pw_y - _pw_h : _pw_y, _pw_w, _pw_h);
+}
+
+bool GxEPD2_32_BW::_nextWindow()
+{
+  if (_window_index + 1 >= _window_count) return false;
+  _selectWindow(_window_index + 1);
+  _setWindowRamArea();
+  fillScreen(GxEPD_WHITE);
+  _current_page = 0;
+  return true;
+}
+
+void GxEPD2_32_BW::_setWindowRamArea()
+{
+  switch (_panel)
+  {
+    case GxEPD2::GDEP015OC1:
+    case GxEPD2::GDE0213B1:
+    case GxEPD2::GDEH029A1:
+      _setRamEntryWindow(_pw_x, _pw_y, _pw_w, _pw_h, _ram_data_entry_mode);
+      break;
+    case GxEPD2::GDEW027W3:
+      _setPartialRamArea(_pw_x, _pw_y, _pw_w, _pw_h);
+      break;
+    case GxEPD2::GDEW042T2:
+#if !defined(GxEPD2_SHADOW) // else each page sets its window, for old and new data
+      _setPartialRamArea(_pw_x, _pw_y, _pw_w, _pw_h);
+      _writeCommand(0x13);
+#endif
+      break;
+    case GxEPD2::GDEW075T8:
+      _setPartialRamArea(_pw_x, _pw_y, _pw_w, _pw_h);
+      _writeCommand(0x10);
+      break;
+  }
+}
+
+void GxEPD2_32_BW::_refreshWindows()
+{
+  // one refresh over the union of the windows, unless the union is much larger than the windows
+  uint16_t xs = WIDTH, ys = HEIGHT, xe = 0, ye = 0;
+  uint32_t area = 0;
+  for (uint8_t i = 0; i < _window_count; i++)
+  {
+    const GxEPD2::Window& pw = _windows[i];
+    xs = gx_uint16_min(xs, pw.x);
+    ys = gx_uint16_min(ys, pw.y);
+    xe = gx_uint16_max(xe, pw.x + pw.w);
+    ye = gx_uint16_max(ye, pw.y + pw.h);
+    area += uint32_t(pw.w) * pw.h;
+  }
+  if (_cleanRefreshDue())
+  {
+    _Update_Clean(xs, ys, xe - xs, ye - ys);
+    return;
+  }
+  for (uint8_t i = 0; i < _window_count; i++)
+  {
+    _countPartialUpdate(_windows[i].x, _windows[i].y, _windows[i].w, _windows[i].h);
+  }
+  bool merge = (_window_count < 2) || (uint32_t(xe - xs) * (ye - ys) <= 2 * area);
+  uint8_t n = merge ? 1 : _window_count;
+  for (uint8_t i = 0; i < n; i++)
+  {
+    GxEPD2::Window pw = merge ? GxEPD2::Window{xs, ys, uint16_t(xe - xs), uint16_t(ye - ys)} : _windows[i];
+    switch (_panel)
+    {
+      case GxEPD2::GDEP015OC1:
+      case GxEPD2::GDE0213B1:
+      case GxEPD2::GDEH029A1:
+        // differential update of the whole screen, covers all windows
+        _Update_Part();
+        return;
+      case GxEPD2::GDEW027W3:
+        _refreshWindow(pw.x, pw.y, pw.w, pw.h);
+        _waitWhileBusy("_refreshWindows", GxEPD2::BusyUpdatePart);
+        break;
+      case GxEPD2::GDEW042T2:
+      case GxEPD2::GDEW075T8:
+        _setPartialRamArea(pw.x, pw.y, pw.w, pw.h);
+        _Update_Part();
+        break;
+    }
+  }
 }
 
 void GxEPD2_32_BW::_PowerOn(void)
@@ -1014,7 +1703,7 @@ void GxEPD2_32_BW::_PowerOn(void)
     {
       _writeCommand(0x04);
     }
-    _waitWhileBusy("_PowerOn");
+    _waitWhileBusy("_PowerOn", GxEPD2::BusyPowerOn);
   }
   _power_is_on = true;
 }
@@ -1031,7 +1720,7 @@ void GxEPD2_32_BW::_PowerOff(void)
   {
     _writeCommand(0x02); // power off
   }
-  _waitWhileBusy("_PowerOff");
+  _waitWhileBusy("_PowerOff", GxEPD2::BusyPowerOff);
   _power_is_on = false;
 }
 
@@ -1051,7 +1740,7 @@ void GxEPD2_32_BW::_InitDisplay(uint8_t em)
       _writeCommand(0x2c); // VCOM setting
       _writeData(0x9b);
       _writeCommand(0x3a); // DummyLine
-      _writeData(0x1a);    // 4 dummy line per gate
+      _writeData(_dummyLines(0x1a)); // 4 dummy line per gate, more in the cold
       _writeCommand(0x3b); // Gatetime
       _writeData(0x08);    // 2us per line
       _setRamEntryWindow(0, 0, WIDTH, HEIGHT, em);
@@ -1068,7 +1757,7 @@ void GxEPD2_32_BW::_InitDisplay(uint8_t em)
       _writeCommand(0x2c); // VCOM setting
       _writeData(0xa8);    // * different
       _writeCommand(0x3a); // DummyLine
-      _writeData(0x1a);    // 4 dummy line per gate
+      _writeData(_dummyLines(0x1a)); // 4 dummy line per gate, more in the cold
       _writeCommand(0x3b); // Gatetime
       _writeData(0x08);    // 2us per line
       _setRamEntryWindow(0, 0, WIDTH, HEIGHT, em);
@@ -1085,7 +1774,7 @@ void GxEPD2_32_BW::_InitDisplay(uint8_t em)
       _writeCommand(0x2c); // VCOM setting
       _writeData(0xa8);    // * different
       _writeCommand(0x3a); // DummyLine
-      _writeData(0x1a);    // 4 dummy line per gate
+      _writeData(_dummyLines(0x1a)); // 4 dummy line per gate, more in the cold
       _writeCommand(0x3b); // Gatetime
       _writeData(0x08);    // 2us per line
       _setRamEntryWindow(0, 0, WIDTH, HEIGHT, em);
@@ -1199,7 +1888,46 @@ void GxEPD2_32_BW::_InitDisplay(uint8_t em)
 
 void GxEPD2_32_BW::_Init_Full(uint8_t em)
 {
+  _Init_Waveform(em, _full_mode);
+}
+
+void GxEPD2_32_BW::_Init_Part(uint8_t em)
+{
+  _Init_Waveform(em, _partial_mode);
+}
+
+void GxEPD2_32_BW::_Init_Clean(uint8_t em)
+{
+  _Init_Waveform(em, _waveforms[GxEPD2::LutClean].tables ? GxEPD2::LutClean : _full_mode);
+}
+
+void GxEPD2_32_BW::_Init_Waveform(uint8_t em, GxEPD2::LutMode mode)
+{
+  GxEPD2_STAT(uint32_t start = micros());
   _InitDisplay(em);
+  // the LUT registers keep their content until reset
+  if (mode != _lut_mode)
+  {
+    const GxEPD2::LutTable* tables = _waveforms[mode].tables;
+    for (uint8_t i = 0; i < _waveforms[mode].count; i++)
+    {
+      _writeCommand(tables[i].command);
+      _writeData(tables[i].data, tables[i].size);
+    }
+    if (!tables)
+    {
+      if (mode == GxEPD2::LutGrey) _writeLutGrey();
+      else if ((mode == GxEPD2::LutFull) || (mode == GxEPD2::LutClean)) _writeLutFull();
+      else _writeLutPart();
+    }
+    _lut_mode = mode;
+  }
+  GxEPD2_STAT(_stats.init_us += micros() - start);
+  _PowerOn();
+}
+
+void GxEPD2_32_BW::_writeLutFull()
+{
   switch (_panel)
   {
     case GxEPD2::GDEP015OC1:
@@ -1213,35 +1941,33 @@ void GxEPD2_32_BW::_Init_Full(uint8_t em)
       break;
     case GxEPD2::GDEW027W3:
       _writeCommand(0x20);
-      _writeData(GxGDEW027W3_lut_20_vcomDC, sizeof(GxGDEW027W3_lut_20_vcomDC));
+      _writeLut(GxGDEW027W3_lut_20_vcomDC, sizeof(GxGDEW027W3_lut_20_vcomDC), 2);
       _writeCommand(0x21);
-      _writeData(GxGDEW027W3_lut_21_ww, sizeof(GxGDEW027W3_lut_21_ww));
+      _writeLut(GxGDEW027W3_lut_21_ww, sizeof(GxGDEW027W3_lut_21_ww));
       _writeCommand(0x22);
-      _writeData(GxGDEW027W3_lut_22_bw, sizeof(GxGDEW027W3_lut_22_bw));
+      _writeLut(GxGDEW027W3_lut_22_bw, sizeof(GxGDEW027W3_lut_22_bw));
       _writeCommand(0x23);
-      _writeData(GxGDEW027W3_lut_23_wb, sizeof(GxGDEW027W3_lut_23_wb));
+      _writeLut(GxGDEW027W3_lut_23_wb, sizeof(GxGDEW027W3_lut_23_wb));
       _writeCommand(0x24);
-      _writeData(GxGDEW027W3_lut_24_bb, sizeof(GxGDEW027W3_lut_24_bb));
+      _writeLut(GxGDEW027W3_lut_24_bb, sizeof(GxGDEW027W3_lut_24_bb));
       break;
     case GxEPD2::GDEW042T2:
       _writeCommand(0x20);
-      _writeData(GxGDEW042T2_lut_20_vcom0_full, sizeof(GxGDEW042T2_lut_20_vcom0_full));
+      _writeLut(GxGDEW042T2_lut_20_vcom0_full, sizeof(GxGDEW042T2_lut_20_vcom0_full));
       _writeCommand(0x21);
-      _writeData(GxGDEW042T2_lut_21_ww_full, sizeof(GxGDEW042T2_lut_21_ww_full));
+      _writeLut(GxGDEW042T2_lut_21_ww_full, sizeof(GxGDEW042T2_lut_21_ww_full));
       _writeCommand(0x22);
-      _writeData(GxGDEW042T2_lut_22_bw_full, sizeof(GxGDEW042T2_lut_22_bw_full));
+      _writeLut(GxGDEW042T2_lut_22_bw_full, sizeof(GxGDEW042T2_lut_22_bw_full));
       _writeCommand(0x23);
-      _writeData(GxGDEW042T2_lut_23_wb_full, sizeof(GxGDEW042T2_lut_23_wb_full));
+      _writeLut(GxGDEW042T2_lut_23_wb_full, sizeof(GxGDEW042T2_lut_23_wb_full));
       _writeCommand(0x24);
-      _writeData(GxGDEW042T2_lut_24_bb_full, sizeof(GxGDEW042T2_lut_24_bb_full));
+      _writeLut(GxGDEW042T2_lut_24_bb_full, sizeof(GxGDEW042T2_lut_24_bb_full));
       break;
   }
-  _PowerOn();
 }
 
-void GxEPD2_32_BW::_Init_Part(uint8_t em)
+void GxEPD2_32_BW::_writeLutPart()
 {
-  _InitDisplay(em);
   switch (_panel)
   {
     case GxEPD2::GDEP015OC1:
@@ -1256,30 +1982,44 @@ void GxEPD2_32_BW::_Init_Part(uint8_t em)
     case GxEPD2::GDEW027W3:
       // no partial update LUT
       _writeCommand(0x20);
-      _writeData(GxGDEW027W3_lut_20_vcomDC, sizeof(GxGDEW027W3_lut_20_vcomDC));
+      _writeLut(GxGDEW027W3_lut_20_vcomDC, sizeof(GxGDEW027W3_lut_20_vcomDC), 2);
       _writeCommand(0x21);
-      _writeData(GxGDEW027W3_lut_21_ww, sizeof(GxGDEW027W3_lut_21_ww));
+      _writeLut(GxGDEW027W3_lut_21_ww, sizeof(GxGDEW027W3_lut_21_ww));
       _writeCommand(0x22);
-      _writeData(GxGDEW027W3_lut_22_bw, sizeof(GxGDEW027W3_lut_22_bw));
+      _writeLut(GxGDEW027W3_lut_22_bw, sizeof(GxGDEW027W3_lut_22_bw));
       _writeCommand(0x23);
-      _writeData(GxGDEW027W3_lut_23_wb, sizeof(GxGDEW027W3_lut_23_wb));
+      _writeLut(GxGDEW027W3_lut_23_wb, sizeof(GxGDEW027W3_lut_23_wb));
       _writeCommand(0x24);
-      _writeData(GxGDEW027W3_lut_24_bb, sizeof(GxGDEW027W3_lut_24_bb));
+      _writeLut(GxGDEW027W3_lut_24_bb, sizeof(GxGDEW027W3_lut_24_bb));
       break;
     case GxEPD2::GDEW042T2:
       _writeCommand(0x20);
-      _writeData(GxGDEW042T2_lut_20_vcom0_partial, sizeof(GxGDEW042T2_lut_20_vcom0_partial));
+      _writeLut(GxGDEW042T2_lut_20_vcom0_partial, sizeof(GxGDEW042T2_lut_20_vcom0_partial));
       _writeCommand(0x21);
-      _writeData(GxGDEW042T2_lut_21_ww_partial, sizeof(GxGDEW042T2_lut_21_ww_partial));
+      _writeLut(GxGDEW042T2_lut_21_ww_partial, sizeof(GxGDEW042T2_lut_21_ww_partial));
       _writeCommand(0x22);
-      _writeData(GxGDEW042T2_lut_22_bw_partial, sizeof(GxGDEW042T2_lut_22_bw_partial));
+      _writeLut(GxGDEW042T2_lut_22_bw_partial, sizeof(GxGDEW042T2_lut_22_bw_partial));
       _writeCommand(0x23);
-      _writeData(GxGDEW042T2_lut_23_wb_partial, sizeof(GxGDEW042T2_lut_23_wb_partial));
+      _writeLut(GxGDEW042T2_lut_23_wb_partial, sizeof(GxGDEW042T2_lut_23_wb_partial));
       _writeCommand(0x24);
-      _writeData(GxGDEW042T2_lut_24_bb_partial, sizeof(GxGDEW042T2_lut_24_bb_partial));
+      _writeLut(GxGDEW042T2_lut_24_bb_partial, sizeof(GxGDEW042T2_lut_24_bb_partial));
       break;
   }
-  _PowerOn();
+}
+
+void GxEPD2_32_BW::_writeLutGrey()
+{
+  if (_panel != GxEPD2::GDEW042T2) return;
+  _writeCommand(0x20);
+  _writeLut(GxGDEW042T2_lut_20_vcom0_grey, sizeof(GxGDEW042T2_lut_20_vcom0_grey));
+  _writeCommand(0x21);
+  _writeLut(GxGDEW042T2_lut_21_ww_grey, sizeof(GxGDEW042T2_lut_21_ww_grey));
+  _writeCommand(0x22);
+  _writeLut(GxGDEW042T2_lut_22_bw_grey, sizeof(GxGDEW042T2_lut_22_bw_grey));
+  _writeCommand(0x23);
+  _writeLut(GxGDEW042T2_lut_23_wb_grey, sizeof(GxGDEW042T2_lut_23_wb_grey));
+  _writeCommand(0x24);
+  _writeLut(GxGDEW042T2_lut_24_bb_grey, sizeof(GxGDEW042T2_lut_24_bb_grey));
 }
 
 void GxEPD2_32_BW::_Update_Full(void)
@@ -1289,14 +2029,56 @@ void GxEPD2_32_BW::_Update_Full(void)
     _writeCommand(0x22);
     _writeData(0xc4);
     _writeCommand(0x20);
-    _waitWhileBusy("_Update_Full");
+    _waitWhileBusy("_Update_Full", GxEPD2::BusyUpdateFull);
     _writeCommand(0xff);
   }
   else
   {
     _writeCommand(0x12);      //display refresh
-    _waitWhileBusy("_Update_Full");
+    _waitWhileBusy("_Update_Full", GxEPD2::BusyUpdateFull);
   }
+  _resetPartialUpdates(0, 0, WIDTH, HEIGHT);
+  _grey_shown = false;
+#if defined(GxEPD2_SHADOW)
+  // the screen is the new data, the old data RAM is written before the next new data, see _prepareOldData()
+  _old_synced = false;
+  _pending_x = _pending_y = _pending_xe = _pending_ye = 0;
+#endif
+}
+
+void GxEPD2_32_BW::_Update_Clean(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+  // refresh with the full update waveform, removes the ghosting of fast partial updates
+  if (_panel < GxEPD2::GDEW027W3)
+  {
+    // the update covers the whole screen
+    _Init_Clean(_ram_data_entry_mode);
+    _Update_Full();
+    _Init_Part(_ram_data_entry_mode);
+    return;
+  }
+  // GDEW042T2: partial window, extended to the tiles that have spent their budget
+  uint16_t xe = x + w, ye = y + h;
+  for (uint8_t ty = 0; ty < ghosting_tiles; ty++)
+  {
+    for (uint8_t tx = 0; tx < ghosting_tiles; tx++)
+    {
+      if (_partial_updates[ty * ghosting_tiles + tx] < _partial_update_budget) continue;
+      x = gx_uint16_min(x, tx * WIDTH / ghosting_tiles);
+      y = gx_uint16_min(y, ty * HEIGHT / ghosting_tiles);
+      xe = gx_uint16_max(xe, (tx + 1) * WIDTH / ghosting_tiles);
+      ye = gx_uint16_max(ye, (ty + 1) * HEIGHT / ghosting_tiles);
+    }
+  }
+  _Init_Clean(_ram_data_entry_mode);
+  _setPartialRamArea(x, y, xe - x, ye - y);
+  _writeCommand(0x12); //display refresh
+  _waitWhileBusy("_Update_Clean", GxEPD2::BusyUpdateFull);
+  _resetPartialUpdates(x, y, xe - x, ye - y);
+  _Init_Part(_ram_data_entry_mode);
+#if defined(GxEPD2_SHADOW)
+  _syncOldData(x, y, xe - x, ye - y);
+#endif
 }
 
 void GxEPD2_32_BW::_Update_Part(void)
@@ -1306,13 +2088,57 @@ void GxEPD2_32_BW::_Update_Part(void)
     _writeCommand(0x22);
     _writeData(0x04);
     _writeCommand(0x20);
-    _waitWhileBusy("_Update_Part");
+    _waitWhileBusy("_Update_Part", GxEPD2::BusyUpdatePart);
     _writeCommand(0xff);
   }
   else
   {
     _writeCommand(0x12);      //display refresh
-    _waitWhileBusy("_Update_Part");
+    _waitWhileBusy("_Update_Part", GxEPD2::BusyUpdatePart);
+  }
+}
+
+void GxEPD2_32_BW::setPartialUpdateBudget(uint8_t max_partial_updates)
+{
+  _partial_update_budget = max_partial_updates;
+}
+
+bool GxEPD2_32_BW::_cleanRefreshDue()
+{
+  if (!hasFastPartialUpdate() || (_partial_update_budget == 0)) return false;
+  for (uint8_t i = 0; i < ghosting_tiles * ghosting_tiles; i++)
+  {
+    if (_partial_updates[i] >= _partial_update_budget) return true;
+  }
+  return false;
+}
+
+void GxEPD2_32_BW::_countPartialUpdate(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+  if (!hasFastPartialUpdate() || (w == 0) || (h == 0)) return;
+  for (uint8_t ty = y * ghosting_tiles / HEIGHT; ty <= (y + h - 1) * ghosting_tiles / HEIGHT; ty++)
+  {
+    for (uint8_t tx = x * ghosting_tiles / WIDTH; tx <= (x + w - 1) * ghosting_tiles / WIDTH; tx++)
+    {
+      uint8_t& count = _partial_updates[ty * ghosting_tiles + tx];
+      if (count < 255) count++;
+    }
+  }
+}
+
+void GxEPD2_32_BW::_resetPartialUpdates(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+  // only tiles covered completely
+  for (uint8_t ty = 0; ty < ghosting_tiles; ty++)
+  {
+    for (uint8_t tx = 0; tx < ghosting_tiles; tx++)
+    {
+      if ((tx * WIDTH / ghosting_tiles >= x) && ((tx + 1) * WIDTH / ghosting_tiles <= x + w) &&
+          (ty * HEIGHT / ghosting_tiles >= y) && ((ty + 1) * HEIGHT / ghosting_tiles <= y + h))
+      {
+        _partial_updates[ty * ghosting_tiles + tx] = 0;
+      }
+    }
   }
 }
 
@@ -1337,3 +2163,13 @@ void GxEPD2_32_BW::_rotate(uint16_t& x, uint16_t& y, uint16_t& w, uint16_t& h)
   }
 }
 
+void GxEPD2_32_BW::_setPageArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+  // page buffer stride and height follow the area, to use the whole buffer also for small windows
+  _area_x = x & 0xFFF8; // byte boundary
+  _area_y = y;
+  _area_width_bytes = (w > 0) ? ((x + w - 1) / 8) - (x / 8) + 1 : 0; // incl. partial bytes
+  _area_height = h;
+  _page_height = _page_buffer_size / gx_uint16_max(_area_width_bytes * (_grey ? 2 : 1), 1);
+  _pages = (h / _page_height) + ((h % _page_height) > 0);
+}
@@ -17,6 +17,8 @@
 class GxEPD2_32_BW : public Adafruit_GFX
 {
   private:
+    static const uint8_t max_windows = 8;
+    static const uint8_t ghosting_tiles = 4; // per direction, for partial update counts
     // ~15k full screen buffer for GDEW042T2 is a good compromise
     static const uint16_t buffer_size = 400 * 300 / 8; // 15'000 bytes
     // 30k full screen buffer for GDEW075T8 will nearly fill ESP8266
@@ -40,15 +42,68 @@ class GxEPD2_32_BW : public Adafruit_GFX
     {
       return ((_panel < GxEPD2::GDEW027W3) || (_panel == GxEPD2::GDEW042T2));
     }
+    bool hasGreyLevels()
+    {
+      return (_panel == GxEPD2::GDEW042T2);
+    }
     bool mirror(bool m);
-    void init();
+    // resume: after deep sleep with the controller still powered, skips the reset pulse
+    // and keeps the state set by restoreState(), e.g. no initial full refresh
+    void init(bool resume = false);
+    // before deep sleep, to memory that is retained, e.g. RTC_DATA_ATTR on ESP32
+    void saveState(GxEPD2::RetainedState& state);
+    // after wake up, before init(true); false if the state is not valid for this panel, then use init()
+    // with GxEPD2_SHADOW the GDEW042T2 shadow is lost, the next update is a full refresh
+    // set the same custom waveforms as before deep sleep, the loaded LUT is not uploaded again
+    bool restoreState(const GxEPD2::RetainedState& state);
     void fillScreen(uint16_t color); // 0x0 black, >0x0 white, to buffer
     void setFullWindow();
     void setPartialWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+    // additional window for the same picture loop, windows are refreshed together; up to max_windows
+    void addPartialWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
     void firstPage();
     bool nextPage();
+    // transfer and timing statistics, collected only if GxEPD2_STATISTICS is defined in GxEPD2.h
+    const GxEPD2::Statistics& statistics();
+    void resetStatistics();
+#if defined(GxEPD2_TRACE)
+    // command stream trace, use trace().print(Serial) to export
+    GxEPD2_32_Trace& trace()
+    {
+      return _trace;
+    };
+#endif
+#if defined(GxEPD2_BUFFER_ARENA)
+    // page buffer for the picture loops, size up to 65535; call before init()
+    // false if smaller than one row of the panel, two in grey mode, twice that with GxEPD2_PIPELINE; then not set
+    bool setArena(GxEPD2_32_Arena& arena);
+#endif
+    // false if the shared page buffer is in use by another display
+    bool pageBufferAvailable();
+    // ambient temperature for the waveform, used from the next update, default room temperature;
+    // GDEP015OC1, GDE0213B1, GDEH029A1 (frame time), GDEW027W3, GDEW042T2 (LUT frame counts);
+    // GDEW075T8 uses its internal sensor
+    void setTemperature(int8_t celsius);
+    // custom waveform for an update type, for the panels with register LUTs (not GDEW075T8)
+    // tables are written in order, as given, e.g. {0x32, lut, 30} for SSD16xx or 0x20..0x24 for GDEW042T2
+    // tables must stay valid; 0 reverts to the built-in waveform
+    bool setWaveform(GxEPD2::LutMode mode, const GxEPD2::LutTable* tables, uint8_t count);
+    // waveforms for full and partial updates, default LutFull and LutPartial, e.g. LutFast for counters;
+    // a mode without custom tables uses the built-in full or partial waveform.
+    // LUTs are uploaded only if changed, refresh with LutClean (if set) when the partial update budget is spent
+    void selectWaveforms(GxEPD2::LutMode full_mode, GxEPD2::LutMode partial_mode);
+    // 4 grey levels (GxEPD_BLACK, GxEPD_DARKGREY, GxEPD_LIGHTGREY, GxEPD_WHITE) in the picture loop, GDEW042T2 only
+    // 2 bits per pixel, so twice the pages; full screen refresh with the LutGrey waveform, partial windows are ignored
+    // returns false if not supported; leaving grey mode after a grey picture writes both RAM planes white,
+    // the next update is then a full screen refresh, also for partial windows (the screen outside them is white)
+    bool setGreyMode(bool grey);
+    // called repeatedly while waiting on BUSY, instead of delay(1); may do work for other devices, not for this display
+    void setBusyCallback(void (*busyCallback)(const void*, GxEPD2::BusyPhase), const void* busy_callback_parameter = 0);
     // partial update keeps power on
     void powerOff(void);
+    // fast partial update: do a clean refresh with the full waveform instead of the next partial update,
+    // once part of the screen has had max_partial_updates partial updates; 0 (default) disables
+    void setPartialUpdateBudget(uint8_t max_partial_updates);
     void drawInvertedBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color);
     //  Support for Bitmaps (Sprites) to Controller Buffer and to Screen
     void clearScreen(uint8_t value = 0xFF); // init controller memory and screen (default white)
@@ -59,9 +114,17 @@ class GxEPD2_32_BW : public Adafruit_GFX
     // write to controller memory, with screen refresh; x and w should be multiple of 8
     void drawImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
     void drawImage(const uint8_t* black, const uint8_t* red, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
+    // write to controller memory row by row, without screen refresh; x and w should be multiple of 8
+    // the controller window is set once by beginImage(), each row is w pixels padded to bytes
+    // bottom_up: rows come bottom first, e.g. BMP files; except on SSD16xx panels pass many rows per call
+    void beginImage(int16_t x, int16_t y, int16_t w, int16_t h, bool bottom_up = false);
+    void writeImageRows(const uint8_t bitmap[], int16_t rows, bool invert = false, bool pgm = false);
+    void writeImageRows(const uint8_t* black, const uint8_t* red, int16_t rows, bool invert = false, bool pgm = false);
+    void endImage();
     void refresh(bool partial_update_mode = false); // screen refresh from controller memory to full screen
     void refresh(int16_t x, int16_t y, int16_t w, int16_t h); // screen refresh from controller memory, partial screen
   private:
+    friend class GxEPD2_32_HostBenchmark; // extras/host, times the private pixel expansion
     template <typename T> static inline void
     swap(T& a, T& b)
     {
@@ -70,6 +133,7 @@ class GxEPD2_32_BW : public Adafruit_GFX
       b = t;
     }
     void _writeScreenBuffer(uint8_t value);
+    bool _nextPage();
     bool _nextPageFull();
     bool _nextPagePart();
     bool _nextPageFull27();
@@ -78,10 +142,32 @@ class GxEPD2_32_BW : public Adafruit_GFX
     bool _nextPagePart42();
     bool _nextPageFull75();
     bool _nextPagePart75();
+    bool _nextPageGrey();
+    void _writeGreyPlane(uint8_t command, uint8_t bit, uint16_t bytes);
+    void _clearGreyPlanes();
+    void _refreshAfterGrey();
+#if defined(GxEPD2_SHADOW)
+    void _prepareOldData();
+    void _beginNewData(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+    void _writePageChanges(uint16_t page_ys, uint16_t rows);
+    void _refreshPart42(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+    void _syncOldData(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+#endif
+    void _setBufferSize(uint16_t size);
+    bool _borrowBuffer();
+    void _releaseBuffer();
+    void _sendPage(uint16_t bytes);
+    static void _transmitPage(void* pv, const uint8_t* data, uint16_t bytes);
     void _send8pixel(uint8_t data);
+    void _send8pixelRepeat(uint8_t data, uint16_t count);
+    void _writeImageRow(const uint8_t* row, int16_t y, bool invert, bool pgm);
+    uint8_t _dummyLines(uint8_t lines);
+    void _writeLut(const uint8_t* lut, uint8_t n, uint8_t offset = 0);
     void _writeCommand(uint8_t c);
     void _writeData(uint8_t d);
     void _writeData(const uint8_t* data, uint16_t n);
+    void _writeDataRepeat(const uint8_t* pattern, uint8_t len, uint16_t count);
+    void _writeDataRepeat(uint8_t value, uint16_t count);
     void _writeCommandData(const uint8_t* pCommandData, uint8_t datalen);
     void _setRamEntryWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t em);
     void _setRamArea(uint16_t xs, uint16_t xe, uint16_t ys, uint16_t ye);
@@ -91,13 +177,27 @@ class GxEPD2_32_BW : public Adafruit_GFX
     void _refreshWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
     void _PowerOn(void);
     void _PowerOff(void);
-    void _waitWhileBusy(const char* comment = 0);
+    void _waitWhileBusy(const char* comment = 0, GxEPD2::BusyPhase phase = GxEPD2::BusyOther);
     void _InitDisplay(uint8_t em);
     void _Init_Full(uint8_t em);
     void _Init_Part(uint8_t em);
+    void _Init_Clean(uint8_t em);
+    void _Init_Waveform(uint8_t em, GxEPD2::LutMode mode);
+    void _writeLutFull();
+    void _writeLutPart();
+    void _writeLutGrey();
     void _Update_Full(void);
     void _Update_Part(void);
+    void _Update_Clean(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+    bool _cleanRefreshDue();
+    void _countPartialUpdate(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+    void _resetPartialUpdates(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
     void _rotate(uint16_t& x, uint16_t& y, uint16_t& w, uint16_t& h);
+    void _setPageArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+    void _selectWindow(uint8_t index);
+    bool _nextWindow();
+    void _setWindowRamArea();
+    void _refreshWindows();
     static inline uint16_t gx_uint16_min(uint16_t a, uint16_t b)
     {
       return (a < b ? a : b);
@@ -106,6 +206,14 @@ class GxEPD2_32_BW : public Adafruit_GFX
     {
       return (a > b ? a : b);
     };
+    static inline int16_t gx_int16_min(int16_t a, int16_t b)
+    {
+      return (a < b ? a : b);
+    };
+    static inline int16_t gx_int16_max(int16_t a, int16_t b)
+    {
+      return (a > b ? a : b);
+    };
   protected:
     GxEPD2::Panel _panel;
     int8_t _cs, _dc, _rst, _busy;
@@ -113,9 +221,51 @@ class GxEPD2_32_BW : public Adafruit_GFX
     uint16_t _width_bytes, _pixel_bytes;
     int16_t _current_page;
     uint16_t _pages, _page_height;
-    bool _initial, _power_is_on, _using_partial_mode, _second_phase, _reverse, _mirror;
+    uint16_t _area_x, _area_y, _area_width_bytes, _area_height; // page buffer geometry
+    bool _initial, _power_is_on, _using_partial_mode, _second_phase, _reverse, _mirror, _image_active, _image_bottom_up;
+    bool _grey; // 2 bits per pixel page buffer, see setGreyMode()
+    bool _grey_shown; // a grey picture is on the screen, which only a full refresh removes
+#if defined(GxEPD2_SHADOW)
+    static const uint16_t shadow_size = 400 * 300 / 8; // GDEW042T2
+    uint8_t _shadow[shadow_size]; // GDEW042T2 new data RAM, as sent (1 is white)
+    bool _old_synced; // old data RAM is the screen, except in the pending area; false after a full refresh
+    uint16_t _pending_x, _pending_y, _pending_xe, _pending_ye; // new data not yet in the old data RAM, x on bytes
+#endif
+    int16_t _image_wb, _image_dxb, _image_w1b, _image_dy, _image_h, _image_h1, _image_row; // beginImage() geometry
+    uint16_t _image_x1, _image_y1;
     uint16_t _pw_x, _pw_y, _pw_w, _pw_h;
+    GxEPD2::Window _windows[max_windows];
+    uint8_t _window_count, _window_index;
+    GxEPD2::LutMode _lut_mode; // loaded by last _Init_Waveform(), LutNone if unknown
+    GxEPD2::LutMode _full_mode, _partial_mode;
+    struct
+    {
+      const GxEPD2::LutTable* tables;
+      uint8_t count;
+    } _waveforms[GxEPD2::LutModes];
+    uint16_t _lut_scale; // percent, see setTemperature()
+    void (*_busy_callback)(const void*, GxEPD2::BusyPhase);
+    const void* _busy_callback_parameter;
+#if defined(GxEPD2_STATISTICS)
+    GxEPD2::Statistics _stats;
+    uint32_t _render_start;
+#endif
+#if defined(GxEPD2_TRACE)
+    GxEPD2_32_Trace _trace;
+#endif
+    uint8_t _partial_update_budget;
+    uint8_t _partial_updates[ghosting_tiles * ghosting_tiles];
+#if defined(GxEPD2_BUFFER_ARENA)
+    GxEPD2_32_Arena* _arena;
+    uint8_t* _buffer; // borrowed from _arena during picture loops
+#else
     uint8_t _buffer[buffer_size];
+#endif
+    uint8_t* _page_buffer; // the part of _buffer being drawn
+    uint16_t _page_buffer_size;
+#if defined(GxEPD2_PIPELINE)
+    GxEPD2_32_Pipeline _pipeline;
+#endif
 };
 
 #endif
@@ -0,0 +1,99 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_32
+//
+// Refresh coalescing front end, for GxEPD2_32_BW or GxEPD2_32_3C.
+// Changes only mark regions dirty; tick() does at most one refresh per minimum interval,
+// over the merged dirty regions, drawn by the draw callback from the newest state.
+// Intermediate states are never sent to the display.
+
+#ifndef _GxEPD2_32_Coalescer_H_
+#define _GxEPD2_32_Coalescer_H_
+
+#include "GxEPD2.h"
+
+template<typename GxEPD2_Type> class GxEPD2_32_Coalescer
+{
+  public:
+    static const uint8_t max_regions = 8;
+    // drawCallback draws the current content, it is called for each page of the refresh
+    GxEPD2_32_Coalescer(GxEPD2_Type& display, void (*drawCallback)(GxEPD2_Type&, const void*), const void* pv = 0, uint32_t min_interval_ms = 1000) :
+      _display(display), _drawCallback(drawCallback), _pv(pv), _min_interval_ms(min_interval_ms),
+      _last_refresh_ms(0), _region_count(0), _full(false), _refreshed(false)
+    {
+    }
+    void setMinInterval(uint32_t min_interval_ms)
+    {
+      _min_interval_ms = min_interval_ms;
+    }
+    // region in display (rotated) coordinates
+    void markDirty(int16_t x, int16_t y, int16_t w, int16_t h)
+    {
+      if (x < 0)
+      {
+        w += x;
+        x = 0;
+      }
+      if (y < 0)
+      {
+        h += y;
+        y = 0;
+      }
+      if ((w <= 0) || (h <= 0)) return;
+      _region_count = GxEPD2::addWindow(_regions, _region_count, max_regions, x, y, w, h);
+    }
+    // next refresh is a full screen refresh
+    void markAllDirty()
+    {
+      _full = true;
+    }
+    bool pending()
+    {
+      return _full || (_region_count > 0);
+    }
+    // call often, e.g. from loop(); returns true if a refresh was done
+    bool tick()
+    {
+      if (!pending()) return false;
+      if (_refreshed && (millis() - _last_refresh_ms < _min_interval_ms)) return false;
+      if (_full || !_display.hasPartialUpdate())
+      {
+        _display.setFullWindow();
+      }
+      else
+      {
+        _display.setPartialWindow(_regions[0].x, _regions[0].y, _regions[0].w, _regions[0].h);
+        for (uint8_t i = 1; i < _region_count; i++)
+        {
+          _display.addPartialWindow(_regions[i].x, _regions[i].y, _regions[i].w, _regions[i].h);
+        }
+      }
+      // changes marked from the draw callback go to the next refresh
+      _region_count = 0;
+      _full = false;
+      _display.firstPage();
+      do
+      {
+        _drawCallback(_display, _pv);
+      }
+      while (_display.nextPage());
+      _last_refresh_ms = millis();
+      _refreshed = true;
+      return true;
+    }
+  private:
+    GxEPD2_Type& _display;
+    void (*_drawCallback)(GxEPD2_Type&, const void*);
+    const void* _pv;
+    uint32_t _min_interval_ms, _last_refresh_ms;
+    GxEPD2::Window _regions[max_regions];
+    uint8_t _region_count;
+    bool _full, _refreshed;
+};
+
+#endif
@@ -0,0 +1,295 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_32
+
+#include "GxEPD2_32_HttpImageSource.h"
+#include <stdlib.h>
+#include <ctype.h>
+
+// value of a header line "Name: value" if the name matches, case insensitive, else 0
+static const char* headerValue(const char* line, const char* name)
+{
+  for (; *name; line++, name++)
+  {
+    if (tolower(uint8_t(*line)) != *name) return 0;
+  }
+  if (*line++ != ':') return 0;
+  while (*line == ' ') line++;
+  return line;
+}
+
+static void copyValidator(char* to, const char* value)
+{
+  if (strlen(value) > GxEPD2_32_HttpImageSource::max_validator_length) to[0] = 0;
+  else strcpy(to, value);
+}
+
+static bool containsToken(const char* value, const char* token)
+{
+  for (; *value; value++)
+  {
+    uint8_t i = 0;
+    while (token[i] && (tolower(uint8_t(value[i])) == token[i])) i++;
+    if (!token[i]) return true;
+  }
+  return false;
+}
+
+GxEPD2_32_HttpImageSource::GxEPD2_32_HttpImageSource(Client& client) :
+  _client(client), _head(0), _tail(0), _port(0), _status(0), _content_length(-1), _remaining(0), _bytes_read(0),
+  _timeout_ms(5000), _chunked(false), _chunk_crlf(false), _keep_alive(false), _body_end(true)
+{
+  _host[0] = 0;
+  _etag[0] = 0;
+  _last_modified[0] = 0;
+}
+
+bool GxEPD2_32_HttpImageSource::connect(const char* host, uint16_t port)
+{
+  if (strlen(host) > max_host_length) return false;
+  bool same = (port == _port) && (strcmp(host, _host) == 0);
+  if (same && _keep_alive && _body_end && _client.connected()) return true;
+  stop();
+  if (!same)
+  {
+    strcpy(_host, host);
+    _port = port;
+  }
+  _keep_alive = _client.connect(_host, _port);
+  return _keep_alive;
+}
+
+int16_t GxEPD2_32_HttpImageSource::get(const char* path, const char* headers)
+{
+  if (!_host[0]) return 0;
+  bool reused = _keep_alive && _body_end && _client.connected();
+  if (!connect(_host, _port)) return 0;
+  int16_t status = _get(path, headers);
+  if (!status && reused)
+  {
+    // the server may close a kept connection at any time
+    stop();
+    if (connect(_host, _port)) status = _get(path, headers);
+  }
+  return status;
+}
+
+void GxEPD2_32_HttpImageSource::stop()
+{
+  _client.stop();
+  _head = _tail = 0;
+  _keep_alive = false;
+  _body_end = true;
+}
+
+uint16_t GxEPD2_32_HttpImageSource::poll()
+{
+  uint16_t moved = 0;
+  for (;;)
+  {
+    int available = _client.available();
+    uint16_t head = _head & (ring_size - 1);
+    uint16_t n = ring_size - _used(); // free
+    if ((available <= 0) || (n == 0)) break;
+    if (n > ring_size - head) n = ring_size - head; // contiguous
+    if (uint32_t(available) < n) n = available;
+    int got = _client.read(_ring + head, n);
+    if (got <= 0) break;
+    _head += got;
+    moved += got;
+  }
+  return moved;
+}
+
+uint32_t GxEPD2_32_HttpImageSource::read(uint8_t* buffer, uint32_t n)
+{
+  uint32_t got = 0;
+  while ((got < n) && !_body_end)
+  {
+    if (_remaining == 0)
+    {
+      if (_chunked && _nextChunk()) continue;
+      if (!_chunked) _body_end = true;
+      else if (!_body_end) _keep_alive = false; // broken chunk framing
+      break;
+    }
+    if ((_used() == 0) && !_fill())
+    {
+      // body until close (no length) ends here, else it is cut
+      if ((_content_length < 0) && !_chunked && !_client.connected()) _body_end = true;
+      _keep_alive = false;
+      break;
+    }
+    uint16_t tail = _tail & (ring_size - 1);
+    uint32_t take = n - got;
+    if (take > _remaining) take = _remaining;
+    if (take > _used()) take = _used();
+    if (take > uint32_t(ring_size - tail)) take = ring_size - tail;
+    if (buffer) memcpy(buffer + got, _ring + tail, take);
+    _tail += take;
+    _remaining -= take;
+    _bytes_read += take;
+    got += take;
+    if (_remaining == 0)
+    {
+      if (_chunked) _chunk_crlf = true;
+      else _body_end = true;
+    }
+  }
+  return got;
+}
+
+int16_t GxEPD2_32_HttpImageSource::read()
+{
+  uint8_t b;
+  return read(&b, 1) ? b : -1;
+}
+
+uint16_t GxEPD2_32_HttpImageSource::read16()
+{
+  uint8_t b[2] = {0, 0};
+  read(b, 2);
+  return b[0] | (uint16_t(b[1]) << 8);
+}
+
+uint32_t GxEPD2_32_HttpImageSource::read32()
+{
+  uint8_t b[4] = {0, 0, 0, 0};
+  read(b, 4);
+  return b[0] | (uint32_t(b[1]) << 8) | (uint32_t(b[2]) << 16) | (uint32_t(b[3]) << 24);
+}
+
+uint32_t GxEPD2_32_HttpImageSource::skip(uint32_t n)
+{
+  return read(0, n);
+}
+
+int16_t GxEPD2_32_HttpImageSource::_get(const char* path, const char* headers)
+{
+  _status = 0;
+  _content_length = -1;
+  _remaining = 0;
+  _bytes_read = 0;
+  _chunked = false;
+  _chunk_crlf = false;
+  _body_end = false;
+  _etag[0] = 0;
+  _last_modified[0] = 0;
+  _send("GET ");
+  _send(path);
+  _send(" HTTP/1.1\r\nHost: ");
+  _send(_host);
+  _send("\r\nUser-Agent: GxEPD2_32\r\nConnection: keep-alive\r\n");
+  if (headers) _send(headers);
+  _send("\r\n");
+  if (!_readHeaders())
+  {
+    stop();
+    _status = 0;
+  }
+  return _status;
+}
+
+void GxEPD2_32_HttpImageSource::_send(const char* s)
+{
+  _client.write(reinterpret_cast<const uint8_t*>(s), strlen(s));
+}
+
+bool GxEPD2_32_HttpImageSource::_readHeaders()
+{
+  char line[128];
+  if (!_readLine(line, sizeof(line)) || (strncmp(line, "HTTP/1.", 7) != 0)) return false;
+  _keep_alive = (line[7] == '1'); // HTTP/1.0 closes by default
+  const char* code = strchr(line, ' ');
+  if (!code) return false;
+  _status = atoi(code + 1);
+  for (;;)
+  {
+    if (!_readLine(line, sizeof(line))) return false;
+    if (!line[0]) break; // end of headers
+    const char* value;
+    if ((value = headerValue(line, "content-length"))) _content_length = atol(value);
+    else if ((value = headerValue(line, "transfer-encoding"))) _chunked = containsToken(value, "chunked");
+    else if ((value = headerValue(line, "etag"))) copyValidator(_etag, value);
+    else if ((value = headerValue(line, "last-modified"))) copyValidator(_last_modified, value);
+    else if ((value = headerValue(line, "connection")))
+    {
+      if (containsToken(value, "close")) _keep_alive = false;
+      else if (containsToken(value, "keep-alive")) _keep_alive = true;
+    }
+  }
+  if ((_status == 204) || (_status == 304) || (_status < 200))
+  {
+    _content_length = 0; // no body
+    _body_end = true;
+  }
+  else if (_chunked)
+  {
+    _content_length = -1;
+  }
+  else if (_content_length >= 0)
+  {
+    _remaining = _content_length;
+    _body_end = (_remaining == 0);
+  }
+  else
+  {
+    _remaining = 0xFFFFFFFF; // until close
+    _keep_alive = false;
+  }
+  return true;
+}
+
+bool GxEPD2_32_HttpImageSource::_readLine(char* line, uint16_t size)
+{
+  // without the line end, longer lines are cut
+  uint16_t n = 0;
+  for (;;)
+  {
+    int16_t c = _rawByte();
+    if (c < 0) return false;
+    if (c == '\n') break;
+    if ((c != '\r') && (n < size - 1)) line[n++] = c;
+  }
+  line[n] = 0;
+  return true;
+}
+
+int16_t GxEPD2_32_HttpImageSource::_rawByte()
+{
+  if ((_used() == 0) && !_fill()) return -1;
+  return _ring[_tail++ & (ring_size - 1)];
+}
+
+bool GxEPD2_32_HttpImageSource::_nextChunk()
+{
+  // chunk: size in hex, optional extensions, CRLF, data, CRLF; the last chunk has size 0, then trailers
+  char line[32];
+  if (_chunk_crlf && !_readLine(line, sizeof(line))) return false;
+  _chunk_crlf = false;
+  if (!_readLine(line, sizeof(line))) return false;
+  _remaining = strtoul(line, 0, 16);
+  if (_remaining > 0) return true;
+  bool ok;
+  while ((ok = _readLine(line, sizeof(line))) && line[0]);
+  _body_end = ok;
+  return false;
+}
+
+bool GxEPD2_32_HttpImageSource::_fill()
+{
+  // called with an empty ring, waits for data
+  uint32_t start = millis();
+  while (poll() == 0)
+  {
+    if (!_client.connected() && (_client.available() <= 0)) return false;
+    if (millis() - start >= _timeout_ms) return false;
+    yield();
+  }
+  return true;
+}
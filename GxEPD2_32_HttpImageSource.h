@@ -0,0 +1,110 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_32
+//
+// HTTP/1.1 GET over any Arduino Client (WiFiClient, WiFiClientSecure, EthernetClient), for image downloads.
+// The connection is kept alive for the next get() to the same host; Content-Length and chunked bodies are decoded.
+// A ring buffer is filled from what the client has available, without waiting; read() waits only if it is empty,
+// with a timeout. The body is read like a file, e.g. BMP headers with read16()/read32(), rows with read(),
+// and the rows go to beginImage()/writeImageRows()/endImage() of the display.
+
+#ifndef _GxEPD2_32_HttpImageSource_H_
+#define _GxEPD2_32_HttpImageSource_H_
+
+#include <Arduino.h>
+#include <Client.h>
+
+class GxEPD2_32_HttpImageSource
+{
+  public:
+    static const uint16_t ring_size = 1024; // power of 2
+    static const uint8_t max_host_length = 63;
+    static const uint8_t max_validator_length = 47; // ETag or Last-Modified of the response, dropped if longer
+    GxEPD2_32_HttpImageSource(Client& client);
+    // keeps the connection if it is open to the same host and port; false for a host longer than max_host_length
+    bool connect(const char* host, uint16_t port = 80);
+    // request path on the connected host, headers: additional request header lines, each ending with "\r\n"
+    // returns the status code, 0 on failure; reconnects once if the server has closed the kept connection
+    int16_t get(const char* path, const char* headers = 0);
+    int16_t status()
+    {
+      return _status;
+    };
+    // -1 if not known, chunked or until close
+    int32_t contentLength()
+    {
+      return _content_length;
+    };
+    // validators of the last response, "" if none, for conditional requests (If-None-Match, If-Modified-Since)
+    const char* etag()
+    {
+      return _etag;
+    };
+    const char* lastModified()
+    {
+      return _last_modified;
+    };
+    const char* host()
+    {
+      return _host;
+    };
+    uint16_t port()
+    {
+      return _port;
+    };
+    // moves the bytes the client has available into the ring buffer, doesn't wait; returns the bytes moved
+    uint16_t poll();
+    // body bytes, waits for data up to the timeout; returns less than n at the end of the body, on close or timeout
+    uint32_t read(uint8_t* buffer, uint32_t n);
+    // one body byte, -1 at the end of the body
+    int16_t read();
+    uint16_t read16(); // little endian, as in BMP files
+    uint32_t read32();
+    uint32_t skip(uint32_t n);
+    // the whole body has been read
+    bool atEnd()
+    {
+      return _body_end;
+    };
+    uint32_t bytesRead()
+    {
+      return _bytes_read;
+    };
+    void setTimeout(uint32_t timeout_ms)
+    {
+      _timeout_ms = timeout_ms;
+    };
+    void stop();
+  private:
+    int16_t _get(const char* path, const char* headers);
+    void _send(const char* s);
+    bool _readHeaders();
+    bool _readLine(char* line, uint16_t size);
+    int16_t _rawByte();
+    bool _nextChunk();
+    bool _fill();
+    uint16_t _used()
+    {
+      return _head - _tail;
+    };
+    Client& _client;
+    uint8_t _ring[ring_size];
+    uint16_t _head, _tail; // free running, masked on access
+    char _host[max_host_length + 1];
+    uint16_t _port;
+    char _etag[max_validator_length + 1];
+    char _last_modified[max_validator_length + 1];
+    int16_t _status;
+    int32_t _content_length;
+    uint32_t _remaining; // body bytes left in the body or the current chunk
+    uint32_t _bytes_read;
+    uint32_t _timeout_ms;
+    bool _chunked, _chunk_crlf, _keep_alive, _body_end;
+};
+
+#endif
@@ -0,0 +1,231 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_32
+
+#include "GxEPD2_32_ImageCache.h"
+
+static const uint32_t index_magic = 0x31435847; // "GXC1"
+
+GxEPD2_32_ImageCache::GxEPD2_32_ImageCache(fs::FS& fs, uint32_t budget, const char* index_name) :
+  _fs(fs), _budget(budget), _used(0), _index_name(index_name), _count(0), _use_counter(0), _index_changed(false)
+{
+}
+
+void GxEPD2_32_ImageCache::begin()
+{
+  _count = 0;
+  _used = 0;
+  _use_counter = 0;
+  _index_changed = false;
+  fs::File index = _fs.open(_index_name, "r");
+  if (!index) return;
+  uint32_t magic = 0;
+  uint8_t count = 0;
+  if ((index.read(reinterpret_cast<uint8_t*>(&magic), sizeof(magic)) == sizeof(magic)) && (magic == index_magic) &&
+      (index.read(&count, 1) == 1) && (count <= max_entries))
+  {
+    for (uint8_t i = 0; i < count; i++)
+    {
+      Entry& e = _entries[_count];
+      if (index.read(reinterpret_cast<uint8_t*>(&e), sizeof(Entry)) != sizeof(Entry)) break;
+      e.name[max_name_length] = 0;
+      // the file must be complete
+      fs::File file = _fs.open(e.name, "r");
+      bool valid = file && (file.size() == e.size);
+      if (file) file.close();
+      if (!valid)
+      {
+        // missing, or incomplete e.g. after a reset during fetch()
+        _fs.remove(e.name);
+        _index_changed = true;
+        continue;
+      }
+      _count++;
+      _used += e.size;
+      if (e.last_use > _use_counter) _use_counter = e.last_use;
+    }
+  }
+  index.close();
+  flush();
+}
+
+GxEPD2_32_ImageCache::Result GxEPD2_32_ImageCache::fetch(GxEPD2_32_HttpImageSource& source, const char* path, const char* name, fs::File& file,
+    StoreCallback store, const void* pv)
+{
+  if (strlen(name) > max_name_length) return CacheFailed;
+  uint32_t url_hash = _hash(source.host(), source.port(), path);
+  Entry* e = _find(name);
+  if (e && (e->url_hash != url_hash))
+  {
+    _remove(e); // other image
+    e = 0;
+  }
+  char headers[2 * (GxEPD2_32_HttpImageSource::max_validator_length + 24)];
+  headers[0] = 0;
+  if (e && e->etag[0])
+  {
+    strcat(headers, "If-None-Match: ");
+    strcat(headers, e->etag);
+    strcat(headers, "\r\n");
+  }
+  if (e && e->last_modified[0])
+  {
+    strcat(headers, "If-Modified-Since: ");
+    strcat(headers, e->last_modified);
+    strcat(headers, "\r\n");
+  }
+  int16_t status = source.get(path, headers[0] ? headers : 0);
+  if ((status == 304) && e)
+  {
+    file = _fs.open(e->name, "r");
+    if (!file)
+    {
+      _remove(e);
+      flush();
+      return CacheFailed;
+    }
+    // the use order is written with the next change or flush()
+    e->last_use = ++_use_counter;
+    _index_changed = true;
+    return CacheHit;
+  }
+  if (status != 200)
+  {
+    flush();
+    return CacheFailed;
+  }
+  if (e) _remove(e); // modified
+  if (!store)
+  {
+    // the stored size is known in advance
+    int32_t length = source.contentLength();
+    if ((length >= 0) && !_makeRoom(length))
+    {
+      flush();
+      return CacheSkipped;
+    }
+    store = _copy;
+  }
+  file = _fs.open(name, "w");
+  if (!file)
+  {
+    flush();
+    return CacheFailed;
+  }
+  bool ok = store(source, file, pv);
+  uint32_t size = file.size();
+  file.close();
+  if (!ok || !_makeRoom(size))
+  {
+    _fs.remove(name);
+    flush();
+    return CacheFailed;
+  }
+  e = _add(name);
+  strcpy(e->etag, source.etag());
+  strcpy(e->last_modified, source.lastModified());
+  e->url_hash = url_hash;
+  e->size = size;
+  e->last_use = ++_use_counter;
+  _used += size;
+  _saveIndex();
+  file = _fs.open(name, "r");
+  return file ? CacheStored : CacheFailed;
+}
+
+void GxEPD2_32_ImageCache::remove(const char* name)
+{
+  Entry* e = _find(name);
+  if (e) _remove(e);
+  flush();
+}
+
+void GxEPD2_32_ImageCache::clear()
+{
+  while (_count > 0) _remove(&_entries[0]);
+  flush();
+}
+
+void GxEPD2_32_ImageCache::flush()
+{
+  if (_index_changed) _saveIndex();
+}
+
+GxEPD2_32_ImageCache::Entry* GxEPD2_32_ImageCache::_find(const char* name)
+{
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    if (strcmp(_entries[i].name, name) == 0) return &_entries[i];
+  }
+  return 0;
+}
+
+GxEPD2_32_ImageCache::Entry* GxEPD2_32_ImageCache::_add(const char* name)
+{
+  // room made by _makeRoom()
+  Entry* e = &_entries[_count++];
+  strcpy(e->name, name);
+  return e;
+}
+
+void GxEPD2_32_ImageCache::_remove(Entry* e)
+{
+  _fs.remove(e->name);
+  _used -= e->size;
+  *e = _entries[--_count];
+  _index_changed = true;
+}
+
+bool GxEPD2_32_ImageCache::_makeRoom(uint32_t size)
+{
+  if (size > _budget) return false;
+  while ((_used + size > _budget) || (_count == max_entries))
+  {
+    Entry* lru = &_entries[0];
+    for (uint8_t i = 1; i < _count; i++)
+    {
+      if (_entries[i].last_use < lru->last_use) lru = &_entries[i];
+    }
+    _remove(lru);
+  }
+  return true;
+}
+
+bool GxEPD2_32_ImageCache::_copy(GxEPD2_32_HttpImageSource& source, fs::File& file, const void* pv)
+{
+  (void) pv;
+  uint8_t buffer[256];
+  uint32_t got;
+  while ((got = source.read(buffer, sizeof(buffer))) > 0)
+  {
+    if (file.write(buffer, got) != got) return false;
+  }
+  return source.atEnd();
+}
+
+void GxEPD2_32_ImageCache::_saveIndex()
+{
+  fs::File index = _fs.open(_index_name, "w");
+  if (!index) return;
+  index.write(reinterpret_cast<const uint8_t*>(&index_magic), sizeof(index_magic));
+  index.write(&_count, 1);
+  index.write(reinterpret_cast<const uint8_t*>(_entries), _count * sizeof(Entry));
+  index.close();
+  _index_changed = false;
+}
+
+uint32_t GxEPD2_32_ImageCache::_hash(const char* host, uint16_t port, const char* path)
+{
+  // FNV-1a
+  uint32_t hash = 2166136261u;
+  for (const char* s = host; *s; s++) hash = (hash ^ uint8_t(*s)) * 16777619u;
+  hash = (hash ^ (port & 0xFF)) * 16777619u;
+  hash = (hash ^ (port >> 8)) * 16777619u;
+  for (const char* s = path; *s; s++) hash = (hash ^ uint8_t(*s)) * 16777619u;
+  return hash;
+}
@@ -0,0 +1,85 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_32
+//
+// Image cache on a file system (SPIFFS, SD), for images loaded with GxEPD2_32_HttpImageSource.
+// Each image is kept in a file with the ETag and Last-Modified of its response; fetch() revalidates it
+// with a conditional GET, and on 304 Not Modified the image is read from the file, without download.
+// The cached files are limited by a byte budget; the least recently used files are removed to make room.
+// A store callback may convert the body on download, e.g. into rows in controller format, to be drawn
+// from the file without conversion.
+
+#ifndef _GxEPD2_32_ImageCache_H_
+#define _GxEPD2_32_ImageCache_H_
+
+#include <Arduino.h>
+#include <FS.h>
+#include "GxEPD2_32_HttpImageSource.h"
+
+class GxEPD2_32_ImageCache
+{
+  public:
+    static const uint8_t max_entries = 16;
+    static const uint8_t max_name_length = 31;
+    enum Result
+    {
+      CacheFailed,  // request failed or file error, see status() of the source
+      CacheHit,     // not modified, file is open on the cached image
+      CacheStored,  // downloaded and stored, file is open on the cached image
+      CacheSkipped  // too large for the budget, not stored; the body is unread, to be read from the source
+    };
+    // writes the body of the source to the file, returns false on failure
+    typedef bool (*StoreCallback)(GxEPD2_32_HttpImageSource& source, fs::File& file, const void* pv);
+    GxEPD2_32_ImageCache(fs::FS& fs, uint32_t budget, const char* index_name = "/gxepd2_cache.idx");
+    // reads the index, drops entries of missing or incomplete files and removes those; call after the file system has started
+    void begin();
+    // path on the host the source is connected to; name of the file for the image, e.g. "/logo.bmp"
+    // store: null to store the body as is
+    Result fetch(GxEPD2_32_HttpImageSource& source, const char* path, const char* name, fs::File& file,
+                 StoreCallback store = 0, const void* pv = 0);
+    // removes the file of name and its entry
+    void remove(const char* name);
+    // removes all cached files
+    void clear();
+    // writes the index if the recent use order has changed since the last write
+    void flush();
+    uint32_t used()
+    {
+      return _used;
+    };
+    uint32_t budget()
+    {
+      return _budget;
+    };
+  private:
+    struct Entry
+    {
+      char name[max_name_length + 1];
+      char etag[GxEPD2_32_HttpImageSource::max_validator_length + 1];
+      char last_modified[GxEPD2_32_HttpImageSource::max_validator_length + 1];
+      uint32_t url_hash;
+      uint32_t size;
+      uint32_t last_use; // use counter value, the lowest is the least recently used
+    };
+    Entry* _find(const char* name);
+    Entry* _add(const char* name);
+    void _remove(Entry* e);
+    bool _makeRoom(uint32_t size);
+    static bool _copy(GxEPD2_32_HttpImageSource& source, fs::File& file, const void* pv);
+    void _saveIndex();
+    static uint32_t _hash(const char* host, uint16_t port, const char* path);
+    fs::FS& _fs;
+    uint32_t _budget, _used;
+    const char* _index_name;
+    Entry _entries[max_entries];
+    uint8_t _count;
+    uint32_t _use_counter;
+    bool _index_changed;
+};
+
+#endif
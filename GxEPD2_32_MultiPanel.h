@@ -0,0 +1,120 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_32
+//
+// Several GxEPD2_32_BW or GxEPD2_32_3C panels on one SPI bus, each with its own CS and BUSY pin.
+// update() runs the picture loop of each panel. While one panel waits on BUSY for a refresh, its busy
+// callback starts the picture loop of the next panel, so uploads overlap refreshes and the refreshes run in parallel.
+// Only one panel uses the bus at any time. A panel continues after its BUSY wait once the panels
+// started meanwhile have finished their picture loops.
+
+#ifndef _GxEPD2_32_MultiPanel_H_
+#define _GxEPD2_32_MultiPanel_H_
+
+#include "GxEPD2.h"
+
+class GxEPD2_32_MultiPanel
+{
+  public:
+    static const uint8_t max_panels = 4;
+    GxEPD2_32_MultiPanel() : _panel_count(0) {}
+    // drawCallback draws the content of the panel, it is called for each page of its picture loop
+    // set the window of the panel (setFullWindow(), setPartialWindow()) before update()
+    template<typename GxEPD2_Type> bool add(GxEPD2_Type& display, void (*drawCallback)(GxEPD2_Type&, const void*), const void* pv = 0)
+    {
+      if (_panel_count == max_panels) return false;
+      Panel& p = _panels[_panel_count++];
+      p.display = &display;
+      p.drawCallback = reinterpret_cast<void (*)()>(drawCallback);
+      p.pv = pv;
+      p.init = _init<GxEPD2_Type>;
+      p.available = _available<GxEPD2_Type>;
+      p.run = _run<GxEPD2_Type>;
+      p.state = Done;
+      display.setBusyCallback(_busyCallback, this);
+      return true;
+    }
+    // inits all panels, SPI.begin() is done once
+    void init()
+    {
+      for (uint8_t i = 0; i < _panel_count; i++)
+      {
+        _panels[i].init(_panels[i]);
+      }
+    }
+    // picture loop on all panels, returns when all are done
+    void update()
+    {
+      for (uint8_t i = 0; i < _panel_count; i++)
+      {
+        _panels[i].state = Pending;
+      }
+      while (_startNext());
+    }
+  private:
+    enum State
+    {
+      Pending, Running, Done
+    };
+    struct Panel
+    {
+      void* display;
+      void (*drawCallback)();
+      const void* pv;
+      void (*init)(Panel&);
+      bool (*available)(Panel&);
+      void (*run)(Panel&);
+      State state;
+    };
+    template<typename GxEPD2_Type> static void _init(Panel& p)
+    {
+      static_cast<GxEPD2_Type*>(p.display)->init();
+    }
+    template<typename GxEPD2_Type> static bool _available(Panel& p)
+    {
+      return static_cast<GxEPD2_Type*>(p.display)->pageBufferAvailable();
+    }
+    template<typename GxEPD2_Type> static void _run(Panel& p)
+    {
+      GxEPD2_Type& display = *static_cast<GxEPD2_Type*>(p.display);
+      void (*drawCallback)(GxEPD2_Type&, const void*) = reinterpret_cast<void (*)(GxEPD2_Type&, const void*)>(p.drawCallback);
+      display.firstPage();
+      do
+      {
+        drawCallback(display, p.pv);
+      }
+      while (display.nextPage());
+    }
+    // runs the picture loop of the next pending panel, returns false if none is pending
+    // with GxEPD2_BUFFER_ARENA a panel waits until the running panel returns the shared page buffer
+    bool _startNext()
+    {
+      for (uint8_t i = 0; i < _panel_count; i++)
+      {
+        Panel& p = _panels[i];
+        if ((p.state != Pending) || !p.available(p)) continue;
+        p.state = Running;
+        p.run(p);
+        p.state = Done;
+        return true;
+      }
+      return false;
+    }
+    // called by a panel waiting on BUSY; the running panels are all waiting, nested in this call chain
+    // the next panel is started during refreshes only, short waits like power on just poll
+    static void _busyCallback(const void* pv, GxEPD2::BusyPhase phase)
+    {
+      GxEPD2_32_MultiPanel* mp = const_cast<GxEPD2_32_MultiPanel*>(static_cast<const GxEPD2_32_MultiPanel*>(pv));
+      bool refresh = (phase == GxEPD2::BusyUpdateFull) || (phase == GxEPD2::BusyUpdatePart);
+      if (!refresh || !mp->_startNext()) delay(1);
+    }
+    Panel _panels[max_panels];
+    uint8_t _panel_count;
+};
+
+#endif
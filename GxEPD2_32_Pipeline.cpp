@@ -0,0 +1,92 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_32
+
+#include "GxEPD2.h"
+
+#if defined(GxEPD2_PIPELINE)
+
+GxEPD2_32_Pipeline::GxEPD2_32_Pipeline(TransmitCallback transmit, void* context) :
+  _transmit(transmit), _context(context), _sent(0), _done(0), _stop(false), _started(false)
+{
+}
+
+GxEPD2_32_Pipeline::~GxEPD2_32_Pipeline()
+{
+  if (!_started) return;
+  wait(0);
+  _stop.store(true);
+#if defined(ESP32)
+  xTaskNotifyGive(_worker_task);
+#else
+  _thread.join();
+#endif
+}
+
+void GxEPD2_32_Pipeline::send(const uint8_t* data, uint16_t bytes)
+{
+  if (!_started) _start(); // not from the constructor, global objects are constructed early
+  Page page = {data, bytes};
+  while (!_queue.push(page)) wait(1);
+  _sent.fetch_add(1, std::memory_order_relaxed);
+#if defined(ESP32)
+  xTaskNotifyGive(_worker_task);
+#endif
+}
+
+void GxEPD2_32_Pipeline::wait(uint8_t pages)
+{
+  while (pending() > pages)
+  {
+#if defined(ESP32)
+    ulTaskNotifyTake(pdTRUE, 1); // notified by the worker after each page
+#else
+    std::this_thread::yield();
+#endif
+  }
+}
+
+void GxEPD2_32_Pipeline::_start()
+{
+  _started = true;
+#if defined(ESP32)
+  // transmit on the core not running the picture loop
+  _producer_task = xTaskGetCurrentTaskHandle();
+  xTaskCreatePinnedToCore(_worker, "GxEPD2_tx", 2048, this, uxTaskPriorityGet(NULL), &_worker_task, xPortGetCoreID() ^ 1);
+#else
+  _thread = std::thread(_worker, this);
+#endif
+}
+
+void GxEPD2_32_Pipeline::_worker(void* pv)
+{
+  GxEPD2_32_Pipeline* p = static_cast<GxEPD2_32_Pipeline*>(pv);
+  while (!p->_stop.load())
+  {
+    Page page;
+    if (!p->_queue.pop(page))
+    {
+#if defined(ESP32)
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+#else
+      std::this_thread::yield();
+#endif
+      continue;
+    }
+    p->_transmit(p->_context, page.data, page.bytes);
+    p->_done.fetch_add(1, std::memory_order_release);
+#if defined(ESP32)
+    xTaskNotifyGive(p->_producer_task);
+#endif
+  }
+#if defined(ESP32)
+  vTaskDelete(NULL);
+#endif
+}
+
+#endif
@@ -0,0 +1,96 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_32
+//
+// Render/transmit pipeline for GxEPD2_32_BW, used if GxEPD2_PIPELINE is defined in GxEPD2.h.
+// The picture loop renders a page into one half of the page buffer, while a worker task on the
+// other core sends the previous page from the other half. Host builds use a std::thread instead.
+// Pages are handed over through a lock-free single-producer/single-consumer queue.
+// While pages are in flight the worker is the only SPI user; wait(0) before sending commands.
+
+#ifndef _GxEPD2_32_Pipeline_H_
+#define _GxEPD2_32_Pipeline_H_
+
+#include <Arduino.h>
+#include <atomic>
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#elif !defined(ARDUINO)
+#include <thread>
+#else
+#error "GxEPD2_PIPELINE needs ESP32, or a host build with threads"
+#endif
+
+// lock-free single-producer/single-consumer ring, holds up to N items
+template<typename T, uint8_t N> class GxEPD2_32_SPSC_Queue
+{
+  public:
+    GxEPD2_32_SPSC_Queue() : _head(0), _tail(0) {}
+    // producer side
+    bool push(const T& item)
+    {
+      uint8_t head = _head.load(std::memory_order_relaxed);
+      uint8_t next = (head + 1) % (N + 1);
+      if (next == _tail.load(std::memory_order_acquire)) return false; // full
+      _items[head] = item;
+      _head.store(next, std::memory_order_release);
+      return true;
+    }
+    // consumer side
+    bool pop(T& item)
+    {
+      uint8_t tail = _tail.load(std::memory_order_relaxed);
+      if (tail == _head.load(std::memory_order_acquire)) return false; // empty
+      item = _items[tail];
+      _tail.store((tail + 1) % (N + 1), std::memory_order_release);
+      return true;
+    }
+  private:
+    T _items[N + 1]; // one slot stays free to tell full from empty
+    std::atomic<uint8_t> _head, _tail;
+};
+
+class GxEPD2_32_Pipeline
+{
+  public:
+    // called on the worker for each page
+    typedef void (*TransmitCallback)(void* context, const uint8_t* data, uint16_t bytes);
+    GxEPD2_32_Pipeline(TransmitCallback transmit, void* context);
+    ~GxEPD2_32_Pipeline();
+    // queue a page for the worker; data must stay untouched until the page is sent, see wait()
+    void send(const uint8_t* data, uint16_t bytes);
+    // wait until at most pages are queued or being sent
+    void wait(uint8_t pages);
+    uint8_t pending()
+    {
+      return uint8_t(_sent.load(std::memory_order_relaxed) - _done.load(std::memory_order_acquire));
+    };
+  private:
+    struct Page
+    {
+      const uint8_t* data;
+      uint16_t bytes;
+    };
+    void _start();
+    static void _worker(void* pv);
+    TransmitCallback _transmit;
+    void* _context;
+    GxEPD2_32_SPSC_Queue<Page, 2> _queue; // the two halves of the page buffer
+    std::atomic<uint8_t> _sent, _done; // written by producer and worker only
+    std::atomic<bool> _stop;
+    bool _started;
+#if defined(ESP32)
+    TaskHandle_t _worker_task, _producer_task;
+#else
+    std::thread _thread;
+#endif
+};
+
+#endif
@@ -0,0 +1,213 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_32
+//
+// Display service for multitasking firmware, for GxEPD2_32_BW or GxEPD2_32_3C.
+// Any task may request() a region update; requests go into a lock-free multi-producer queue
+// and request() never blocks. One owner task calls process(), which merges all queued requests
+// into one picture loop over the changed regions and refreshes them together.
+// Each client is a draw callback with its pv; the latest region of every client seen so far is
+// redrawn by its callback on each page, so clients may share windows. Callbacks run on the owner task.
+
+#ifndef _GxEPD2_32_Service_H_
+#define _GxEPD2_32_Service_H_
+
+#include "GxEPD2.h"
+#include <atomic>
+
+template<typename GxEPD2_Type, uint8_t queue_size = 16> class GxEPD2_32_Service
+{
+  public:
+    static const uint8_t max_clients = 8;
+    typedef void (*DrawCallback)(GxEPD2_Type&, const void*);
+    GxEPD2_32_Service(GxEPD2_Type& display, uint32_t min_interval_ms = 0) :
+      _display(display), _min_interval_ms(min_interval_ms), _last_refresh_ms(0),
+      _enqueue_pos(0), _dequeue_pos(0), _overflow(false), _client_count(0), _full(false), _refreshed(false)
+    {
+      static_assert((queue_size & (queue_size - 1)) == 0, "queue_size must be a power of 2");
+      for (uint8_t i = 0; i < queue_size; i++) _cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    // any task; region in display (rotated) coordinates, drawn by draw(display, pv) on each page
+    // returns false if the queue is full; the next process() then does a full refresh, drawn by all known clients,
+    // but a client not yet known to the service has to retry
+    bool request(int16_t x, int16_t y, int16_t w, int16_t h, DrawCallback draw, const void* pv = 0)
+    {
+      Request r = {x, y, w, h, draw, pv, false};
+      return _push(r);
+    }
+    // any task; next refresh is a full screen refresh, drawn by all clients
+    bool requestFull()
+    {
+      Request r = {0, 0, 0, 0, 0, 0, true};
+      return _push(r);
+    }
+    // owner task only, call often; returns true if a refresh was done
+    bool process()
+    {
+      Request r;
+      while (_pop(r)) _merge(r);
+      // the region of a dropped request is not known, a full refresh covers it
+      if (_overflow.exchange(false)) _full = true;
+      if (!pending()) return false;
+      if (_refreshed && (millis() - _last_refresh_ms < _min_interval_ms)) return false;
+      bool windows = false;
+      if (_full || !_display.hasPartialUpdate())
+      {
+        _display.setFullWindow();
+      }
+      else
+      {
+        for (uint8_t i = 0; i < _client_count; i++)
+        {
+          Client& c = _clients[i];
+          if (!c.dirty) continue;
+          if (!windows) _display.setPartialWindow(c.x, c.y, c.w, c.h);
+          else _display.addPartialWindow(c.x, c.y, c.w, c.h);
+          windows = true;
+        }
+      }
+      // requests queued meanwhile go to the next refresh
+      for (uint8_t i = 0; i < _client_count; i++) _clients[i].dirty = false;
+      _full = false;
+      _display.firstPage();
+      do
+      {
+        _display.fillScreen(GxEPD_WHITE);
+        for (uint8_t i = 0; i < _client_count; i++)
+        {
+          _clients[i].draw(_display, _clients[i].pv);
+        }
+      }
+      while (_display.nextPage());
+      _last_refresh_ms = millis();
+      _refreshed = true;
+      return true;
+    }
+    // owner task only
+    bool pending()
+    {
+      if (_full) return true;
+      for (uint8_t i = 0; i < _client_count; i++)
+      {
+        if (_clients[i].dirty) return true;
+      }
+      return false;
+    }
+  private:
+    struct Request
+    {
+      int16_t x, y, w, h;
+      DrawCallback draw;
+      const void* pv;
+      bool full;
+    };
+    struct Cell
+    {
+      std::atomic<uint16_t> sequence; // == position: free for the producer, == position + 1: ready for the consumer
+      Request request;
+    };
+    struct Client
+    {
+      DrawCallback draw;
+      const void* pv;
+      int16_t x, y, w, h;
+      bool dirty;
+    };
+    // bounded multi-producer queue, with per cell sequence numbers
+    bool _push(const Request& r)
+    {
+      uint16_t pos = _enqueue_pos.load(std::memory_order_relaxed);
+      Cell* cell;
+      for (;;)
+      {
+        cell = &_cells[pos & (queue_size - 1)];
+        int16_t diff = int16_t(cell->sequence.load(std::memory_order_acquire) - pos);
+        if (diff == 0)
+        {
+          if (_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        }
+        else if (diff < 0)
+        {
+          _overflow.store(true);
+          return false;
+        }
+        else pos = _enqueue_pos.load(std::memory_order_relaxed);
+      }
+      cell->request = r;
+      cell->sequence.store(pos + 1, std::memory_order_release);
+      return true;
+    }
+    // single consumer
+    bool _pop(Request& r)
+    {
+      Cell& cell = _cells[_dequeue_pos & (queue_size - 1)];
+      if (int16_t(cell.sequence.load(std::memory_order_acquire) - (_dequeue_pos + 1)) < 0) return false;
+      r = cell.request;
+      cell.sequence.store(_dequeue_pos + queue_size, std::memory_order_release);
+      _dequeue_pos++;
+      return true;
+    }
+    void _merge(const Request& r)
+    {
+      if (r.full)
+      {
+        _full = true;
+        return;
+      }
+      int16_t x = r.x, y = r.y, w = r.w, h = r.h;
+      if (x < 0)
+      {
+        w += x;
+        x = 0;
+      }
+      if (y < 0)
+      {
+        h += y;
+        y = 0;
+      }
+      if (!r.draw || (w <= 0) || (h <= 0)) return;
+      uint8_t i = 0;
+      for (; i < _client_count; i++)
+      {
+        if ((_clients[i].draw == r.draw) && (_clients[i].pv == r.pv)) break;
+      }
+      if (i == _client_count)
+      {
+        if (_client_count == max_clients) return;
+        _clients[_client_count++] = Client{r.draw, r.pv, x, y, w, h, true};
+        return;
+      }
+      Client& c = _clients[i];
+      if (c.dirty)
+      {
+        // burst of the same client: refresh the union of its regions
+        int16_t xe = (x + w > c.x + c.w) ? x + w : c.x + c.w;
+        int16_t ye = (y + h > c.y + c.h) ? y + h : c.y + c.h;
+        x = (x < c.x) ? x : c.x;
+        y = (y < c.y) ? y : c.y;
+        w = xe - x;
+        h = ye - y;
+      }
+      c.x = x;
+      c.y = y;
+      c.w = w;
+      c.h = h;
+      c.dirty = true;
+    }
+    GxEPD2_Type& _display;
+    uint32_t _min_interval_ms, _last_refresh_ms;
+    Cell _cells[queue_size];
+    std::atomic<uint16_t> _enqueue_pos;
+    uint16_t _dequeue_pos;
+    std::atomic<bool> _overflow;
+    Client _clients[max_clients];
+    uint8_t _client_count;
+    bool _full, _refreshed;
+};
+
+#endif
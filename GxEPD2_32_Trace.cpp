@@ -0,0 +1,103 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_32
+
+#include "GxEPD2_32_Trace.h"
+
+GxEPD2_32_Trace::GxEPD2_32_Trace()
+{
+  clear();
+}
+
+void GxEPD2_32_Trace::clear()
+{
+  _head = 0;
+  _count = 0;
+  _dropped = 0;
+}
+
+void GxEPD2_32_Trace::command(uint8_t c, uint32_t start_us, uint32_t end_us)
+{
+  Entry& e = _append();
+  e.start_us = start_us;
+  e.end_us = end_us;
+  e.wire_us = end_us - start_us;
+  e.length = 1;
+  e.kind = Command;
+  e.value = c;
+}
+
+void GxEPD2_32_Trace::data(uint8_t first, uint32_t n, uint32_t start_us, uint32_t end_us)
+{
+  if (_count > 0)
+  {
+    Entry& last = _entries[(_head + entries - 1) % entries];
+    if (last.kind == Data)
+    {
+      last.end_us = end_us;
+      last.wire_us += end_us - start_us;
+      last.length = (last.length + n > 0xFFFF) ? 0xFFFF : last.length + n;
+      return;
+    }
+  }
+  Entry& e = _append();
+  e.start_us = start_us;
+  e.end_us = end_us;
+  e.wire_us = end_us - start_us;
+  e.length = (n > 0xFFFF) ? 0xFFFF : n;
+  e.kind = Data;
+  e.value = first;
+}
+
+void GxEPD2_32_Trace::busy(uint8_t phase, uint32_t start_us, uint32_t end_us)
+{
+  Entry& e = _append();
+  e.start_us = start_us;
+  e.end_us = end_us;
+  e.wire_us = 0;
+  e.length = 0;
+  e.kind = Busy;
+  e.value = phase;
+}
+
+const GxEPD2_32_Trace::Entry& GxEPD2_32_Trace::entry(uint16_t i)
+{
+  return _entries[(_head + entries - _count + i) % entries];
+}
+
+void GxEPD2_32_Trace::print(Print& out)
+{
+  out.print("# GxEPD2 trace, entries ");
+  out.print(_count);
+  out.print(", dropped ");
+  out.println(_dropped);
+  for (uint16_t i = 0; i < _count; i++)
+  {
+    const Entry& e = entry(i);
+    out.print(char(e.kind));
+    out.print(' ');
+    out.print(e.start_us);
+    out.print(' ');
+    out.print(e.end_us);
+    out.print(' ');
+    out.print(e.wire_us);
+    out.print(' ');
+    out.print(e.length);
+    out.print(' ');
+    out.println(e.value, HEX);
+  }
+}
+
+GxEPD2_32_Trace::Entry& GxEPD2_32_Trace::_append()
+{
+  Entry& e = _entries[_head];
+  _head = (_head + 1) % entries;
+  if (_count < entries) _count++;
+  else _dropped++;
+  return e;
+}
@@ -0,0 +1,63 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_32
+//
+// Ring buffer trace of the command stream, recorded if GxEPD2_TRACE is defined in GxEPD2.h.
+// Consecutive data transfers are coalesced into one entry; the oldest entries are overwritten.
+// print() exports the trace as text, extras/trace_replay.py analyzes it on the host.
+
+#ifndef _GxEPD2_32_Trace_H_
+#define _GxEPD2_32_Trace_H_
+
+#include <Arduino.h>
+
+class GxEPD2_32_Trace
+{
+  public:
+#if defined(GxEPD2_TRACE_ENTRIES)
+    static const uint16_t entries = GxEPD2_TRACE_ENTRIES;
+#else
+    static const uint16_t entries = 64; // 16 bytes each
+#endif
+    enum Kind
+    {
+      Command = 'C', Data = 'D', Busy = 'B'
+    };
+    struct Entry
+    {
+      uint32_t start_us, end_us; // first transfer start, last transfer end
+      uint32_t wire_us;          // time spent in the transfers, less than end - start if coalesced with gaps
+      uint16_t length;           // bytes, saturates
+      uint8_t kind;
+      uint8_t value;             // command byte, first data byte, or busy phase
+    };
+    GxEPD2_32_Trace();
+    void clear();
+    void command(uint8_t c, uint32_t start_us, uint32_t end_us);
+    void data(uint8_t first, uint32_t n, uint32_t start_us, uint32_t end_us);
+    void busy(uint8_t phase, uint32_t start_us, uint32_t end_us);
+    uint16_t count()
+    {
+      return _count;
+    };
+    uint32_t dropped()
+    {
+      return _dropped;
+    };
+    // oldest first
+    const Entry& entry(uint16_t i);
+    // one line per entry: kind start_us end_us wire_us length value(hex)
+    void print(Print& out);
+  private:
+    Entry& _append();
+    Entry _entries[entries];
+    uint16_t _head, _count;
+    uint32_t _dropped;
+};
+
+#endif
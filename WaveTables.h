@@ -278,5 +278,61 @@ const unsigned char GxGDEW042T2_lut_24_bb_partial[] =
   0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
 };
 
+// 4 grey levels, old data 0x10 is the level high bit, new data 0x13 the low bit (1 = white)
+const unsigned char GxGDEW042T2_lut_20_vcom0_grey[] =
+{
+  0x00, 0x0A, 0x00, 0x00, 0x00, 0x01,
+  0x60, 0x14, 0x14, 0x00, 0x00, 0x01,
+  0x00, 0x14, 0x00, 0x00, 0x00, 0x01,
+  0x00, 0x13, 0x0A, 0x01, 0x00, 0x01,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+const unsigned char GxGDEW042T2_lut_21_ww_grey[] = // white
+{
+  0x40, 0x0A, 0x00, 0x00, 0x00, 0x01,
+  0x90, 0x14, 0x14, 0x00, 0x00, 0x01,
+  0x10, 0x14, 0x0A, 0x00, 0x00, 0x01,
+  0xA0, 0x13, 0x01, 0x00, 0x00, 0x01,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+const unsigned char GxGDEW042T2_lut_22_bw_grey[] = // dark grey
+{
+  0x40, 0x0A, 0x00, 0x00, 0x00, 0x01,
+  0x90, 0x14, 0x14, 0x00, 0x00, 0x01,
+  0x00, 0x14, 0x0A, 0x00, 0x00, 0x01,
+  0x99, 0x0C, 0x01, 0x03, 0x04, 0x01,
+  0x02, 0x04, 0x01, 0x00, 0x00, 0x01,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+const unsigned char GxGDEW042T2_lut_23_wb_grey[] = // light grey
+{
+  0x40, 0x0A, 0x00, 0x00, 0x00, 0x01,
+  0x90, 0x14, 0x14, 0x00, 0x00, 0x01,
+  0x00, 0x14, 0x0A, 0x00, 0x00, 0x01,
+  0x99, 0x0B, 0x04, 0x04, 0x01, 0x01,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+const unsigned char GxGDEW042T2_lut_24_bb_grey[] = // black
+{
+  0x80, 0x0A, 0x00, 0x00, 0x00, 0x01,
+  0x90, 0x14, 0x14, 0x00, 0x00, 0x01,
+  0x20, 0x14, 0x0A, 0x00, 0x00, 0x01,
+  0x50, 0x13, 0x01, 0x00, 0x00, 0x01,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
 #endif
 
@@ -0,0 +1,218 @@
+// Display Library example for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_32
+
+// Benchmark of the rendering and transfer paths, results as CSV on Serial:
+// panel,operation,rotation,iterations,total_us,bytes
+// drawPixel and fillScreen are measured for every panel, on buffer only instances without pins;
+// the picture loops and writeImage are measured on the connected display.
+// bytes is the number of bytes sent, if GxEPD2_STATISTICS is defined in GxEPD2.h, else 0.
+// extras/host builds the same measurements on Linux, with the pixel expansion timed alone.
+
+// see GxEPD2_32_Example for the mapping suggestions
+
+#include <GxEPD2_32_BW.h>
+#include <GxEPD2_32_3C.h>
+#include <Fonts/FreeMonoBold9pt7b.h>
+
+#if defined (ESP8266)
+// select one and adapt to your mapping
+//GxEPD2_32_BW display(GxEPD2::GDEP015OC1, /*CS=D8*/ SS, /*DC=D3*/ 0, /*RST=D4*/ 2, /*BUSY=D2*/ 4);
+//GxEPD2_32_BW display(GxEPD2::GDE0213B1, /*CS=D8*/ SS, /*DC=D3*/ 0, /*RST=D4*/ 2, /*BUSY=D2*/ 4);
+//GxEPD2_32_BW display(GxEPD2::GDEH029A1, /*CS=D8*/ SS, /*DC=D3*/ 0, /*RST=D4*/ 2, /*BUSY=D2*/ 4);
+//GxEPD2_32_BW display(GxEPD2::GDEW027W3, /*CS=D8*/ SS, /*DC=D3*/ 0, /*RST=D4*/ 2, /*BUSY=D2*/ 4);
+//GxEPD2_32_BW display(GxEPD2::GDEW042T2, /*CS=D8*/ SS, /*DC=D3*/ 0, /*RST=D4*/ 2, /*BUSY=D2*/ 4);
+//GxEPD2_32_BW display(GxEPD2::GDEW075T8,  /*CS=D8*/ SS, /*DC=D3*/ 0, /*RST=D4*/ 2, /*BUSY=D2*/ 4);
+// 3-color e-papers
+//GxEPD2_32_3C display(GxEPD2::GDEW0154Z04,  /*CS=D8*/ SS, /*DC=D3*/ 0, /*RST=D4*/ 2, /*BUSY=D2*/ 4);
+//GxEPD2_32_3C display(GxEPD2::GDEW0213Z16,  /*CS=D8*/ SS, /*DC=D3*/ 0, /*RST=D4*/ 2, /*BUSY=D2*/ 4);
+//GxEPD2_32_3C display(GxEPD2::GDEW029Z10,  /*CS=D8*/ SS, /*DC=D3*/ 0, /*RST=D4*/ 2, /*BUSY=D2*/ 4);
+//GxEPD2_32_3C display(GxEPD2::GDEW027C44,  /*CS=D8*/ SS, /*DC=D3*/ 0, /*RST=D4*/ 2, /*BUSY=D2*/ 4);
+//GxEPD2_32_3C display(GxEPD2::GDEW042Z15,  /*CS=D8*/ SS, /*DC=D3*/ 0, /*RST=D4*/ 2, /*BUSY=D2*/ 4);
+//GxEPD2_32_3C display(GxEPD2::GDEW075Z09,  /*CS=D8*/ SS, /*DC=D3*/ 0, /*RST=D4*/ 2, /*BUSY=D2*/ 4);
+#endif
+
+#if defined(ESP32)
+// select one and adapt to your mapping
+//GxEPD2_32_BW display(GxEPD2::GDEP015OC1, /*CS=5*/ SS, /*DC=*/ 17, /*RST=*/ 16, /*BUSY=*/ 4);
+//GxEPD2_32_BW display(GxEPD2::GDE0213B1, /*CS=5*/ SS, /*DC=*/ 17, /*RST=*/ 16, /*BUSY=*/ 4);
+//GxEPD2_32_BW display(GxEPD2::GDEH029A1, /*CS=5*/ SS, /*DC=*/ 17, /*RST=*/ 16, /*BUSY=*/ 4);
+//GxEPD2_32_BW display(GxEPD2::GDEW027W3, /*CS=5*/ SS, /*DC=*/ 17, /*RST=*/ 16, /*BUSY=*/ 4);
+//GxEPD2_32_BW display(GxEPD2::GDEW042T2, /*CS=5*/ SS, /*DC=*/ 17, /*RST=*/ 16, /*BUSY=*/ 4);
+//GxEPD2_32_BW display(GxEPD2::GDEW075T8, /*CS=5*/ SS, /*DC=*/ 17, /*RST=*/ 16, /*BUSY=*/ 4);
+// 3-color e-papers
+//GxEPD2_32_3C display(GxEPD2::GDEW0154Z04, /*CS=5*/ SS, /*DC=*/ 17, /*RST=*/ 16, /*BUSY=*/ 4);
+//GxEPD2_32_3C display(GxEPD2::GDEW0213Z16, /*CS=5*/ SS, /*DC=*/ 17, /*RST=*/ 16, /*BUSY=*/ 4);
+//GxEPD2_32_3C display(GxEPD2::GDEW029Z10,  /*CS=5*/ SS, /*DC=*/ 17, /*RST=*/ 16, /*BUSY=*/ 4);
+//GxEPD2_32_3C display(GxEPD2::GDEW027C44,  /*CS=5*/ SS, /*DC=*/ 17, /*RST=*/ 16, /*BUSY=*/ 4);
+//GxEPD2_32_3C display(GxEPD2::GDEW042Z15,  /*CS=5*/ SS, /*DC=*/ 17, /*RST=*/ 16, /*BUSY=*/ 4);
+//GxEPD2_32_3C display(GxEPD2::GDEW075Z09,  /*CS=5*/ SS, /*DC=*/ 17, /*RST=*/ 16, /*BUSY=*/ 4);
+#endif
+
+#if defined(_BOARD_GENERIC_STM32F103C_H_)
+// select one and adapt to your mapping
+//GxEPD2_32_BW display(GxEPD2::GDEP015OC1, /*CS=4*/ SS, /*DC=*/ 3, /*RST=*/ 2, /*BUSY=*/ 1);
+//GxEPD2_32_BW display(GxEPD2::GDE0213B1, /*CS=4*/ SS, /*DC=*/ 3, /*RST=*/ 2, /*BUSY=*/ 1);
+//GxEPD2_32_BW display(GxEPD2::GDEH029A1, /*CS=4*/ SS, /*DC=*/ 3, /*RST=*/ 2, /*BUSY=*/ 1);
+//GxEPD2_32_BW display(GxEPD2::GDEW027W3, /*CS=4*/ SS, /*DC=*/ 3, /*RST=*/ 2, /*BUSY=*/ 1);
+//GxEPD2_32_BW display(GxEPD2::GDEW042T2, /*CS=4*/ SS, /*DC=*/ 3, /*RST=*/ 2, /*BUSY=*/ 1);
+//GxEPD2_32_BW display(GxEPD2::GDEW075T8, /*CS=4*/ SS, /*DC=*/ 3, /*RST=*/ 2, /*BUSY=*/ 1);
+// 3-color e-papers
+//GxEPD2_32_3C display(GxEPD2::GDEW0154Z04, /*CS=4*/ SS, /*DC=*/ 3, /*RST=*/ 2, /*BUSY=*/ 1);
+//GxEPD2_32_3C display(GxEPD2::GDEW0213Z16, /*CS=4*/ SS, /*DC=*/ 3, /*RST=*/ 2, /*BUSY=*/ 1);
+//GxEPD2_32_3C display(GxEPD2::GDEW029Z10,  /*CS=4*/ SS, /*DC=*/ 3, /*RST=*/ 2, /*BUSY=*/ 1);
+//GxEPD2_32_3C display(GxEPD2::GDEW027C44,  /*CS=4*/ SS, /*DC=*/ 3, /*RST=*/ 2, /*BUSY=*/ 1);
+//GxEPD2_32_3C display(GxEPD2::GDEW042Z15,  /*CS=4*/ SS, /*DC=*/ 3, /*RST=*/ 2, /*BUSY=*/ 1);
+//GxEPD2_32_3C display(GxEPD2::GDEW075Z09,  /*CS=4*/ SS, /*DC=*/ 3, /*RST=*/ 2, /*BUSY=*/ 1);
+#endif
+
+#include "bitmaps/Bitmaps200x200.h" // 1.54" b/w
+#include "bitmaps/Bitmaps3c200x200.h" // 1.54" b/w/r
+
+const char* panel_names[] =
+{
+  "GDEP015OC1", "GDE0213B1", "GDEH029A1", "GDEW027W3", "GDEW042T2", "GDEW075T8",
+  "GDEW0154Z04", "GDEW0213Z16", "GDEW029Z10", "GDEW027C44", "GDEW042Z15", "GDEW075Z09"
+};
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println();
+  Serial.println("panel,operation,rotation,iterations,total_us,bytes");
+  benchmarkBuffers();
+  display.init();
+  benchmarkDisplay();
+  display.powerOff();
+  Serial.println("# done");
+}
+
+void loop()
+{
+}
+
+void report(GxEPD2::Panel panel, const char* operation, int16_t rotation, uint32_t iterations, uint32_t total_us, uint32_t bytes)
+{
+  Serial.print(panel_names[panel]);
+  Serial.print(',');
+  Serial.print(operation);
+  Serial.print(',');
+  Serial.print(rotation);
+  Serial.print(',');
+  Serial.print(iterations);
+  Serial.print(',');
+  Serial.print(total_us);
+  Serial.print(',');
+  Serial.println(bytes);
+}
+
+void benchmarkGFX(GxEPD2::Panel panel, Adafruit_GFX& gfx)
+{
+  for (uint8_t r = 0; r < 4; r++)
+  {
+    gfx.setRotation(r);
+    uint16_t w = gfx.width(), h = gfx.height();
+    uint32_t start = micros();
+    for (uint16_t y = 0; y < h; y++)
+    {
+      for (uint16_t x = 0; x < w; x++)
+      {
+        gfx.drawPixel(x, y, (x + y) & 1 ? GxEPD_BLACK : GxEPD_WHITE);
+      }
+    }
+    report(panel, "drawPixel", r, uint32_t(w) * h, micros() - start, 0);
+    yield();
+  }
+  gfx.setRotation(0);
+  uint32_t start = micros();
+  for (uint8_t i = 0; i < 10; i++)
+  {
+    gfx.fillScreen(i & 1 ? GxEPD_BLACK : GxEPD_WHITE);
+  }
+  report(panel, "fillScreen", 0, 10, micros() - start, 0);
+}
+
+void benchmarkBuffers()
+{
+  // buffer only instances, no SPI traffic; on the heap, one at a time
+  for (uint8_t p = GxEPD2::GDEP015OC1; p <= GxEPD2::GDEW075T8; p++)
+  {
+    GxEPD2_32_BW* bw = new GxEPD2_32_BW(GxEPD2::Panel(p), -1, -1, -1, -1);
+    if (!bw) continue;
+    benchmarkGFX(GxEPD2::Panel(p), *bw);
+    delete bw;
+  }
+  for (uint8_t p = GxEPD2::GDEW0154Z04; p <= GxEPD2::GDEW075Z09; p++)
+  {
+    GxEPD2_32_3C* c3 = new GxEPD2_32_3C(GxEPD2::Panel(p), -1, -1, -1, -1);
+    if (!c3) continue;
+    benchmarkGFX(GxEPD2::Panel(p), *c3);
+    delete c3;
+  }
+}
+
+uint32_t bytesSent()
+{
+  return display.statistics().command_bytes + display.statistics().data_bytes;
+}
+
+void drawContent()
+{
+  display.fillScreen(GxEPD_WHITE);
+  display.setFont(&FreeMonoBold9pt7b);
+  display.setTextColor(GxEPD_BLACK);
+  display.setCursor(10, 30);
+  display.println("Benchmark");
+  display.fillRect(10, 40, display.width() / 2, 20, display.hasColor() ? GxEPD_RED : GxEPD_BLACK);
+}
+
+void benchmarkPictureLoop(const char* operation)
+{
+  display.resetStatistics();
+  uint32_t start = micros();
+  uint16_t pages = 0;
+  display.firstPage();
+  do
+  {
+    drawContent();
+    pages++;
+  }
+  while (display.nextPage());
+  report(display.panel(), operation, display.getRotation(), pages, micros() - start, bytesSent());
+#if defined(GxEPD2_STATISTICS)
+  const GxEPD2::Statistics& s = display.statistics();
+  report(display.panel(), "render", display.getRotation(), s.pages, s.render_us, 0);
+  report(display.panel(), "spi", display.getRotation(), s.cs_toggles, s.spi_us, bytesSent());
+  report(display.panel(), "busy_update_full", display.getRotation(), 1, s.busy_us[GxEPD2::BusyUpdateFull], 0);
+  report(display.panel(), "busy_update_part", display.getRotation(), 1, s.busy_us[GxEPD2::BusyUpdatePart], 0);
+#endif
+}
+
+void benchmarkDisplay()
+{
+  display.setRotation(0);
+  display.setFullWindow();
+  benchmarkPictureLoop("full_picture_loop");
+  if (display.hasPartialUpdate())
+  {
+    display.setPartialWindow(0, 0, display.width(), display.height() / 4);
+    benchmarkPictureLoop("partial_picture_loop");
+  }
+  // writeImage of the bundled 200x200 bitmaps, clipped to the panel, no refresh
+  display.resetStatistics();
+  uint32_t start = micros();
+  if (display.hasColor())
+  {
+    display.writeImage(Bitmap3c200x200_black, Bitmap3c200x200_red, 0, 0, 200, 200, false, false, true);
+  }
+  else
+  {
+    display.writeImage(logo200x200, 0, 0, 200, 200, false, false, true);
+  }
+  report(display.panel(), "writeImage", 0, 1, micros() - start, bytesSent());
+}
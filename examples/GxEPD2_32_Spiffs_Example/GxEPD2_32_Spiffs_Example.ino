@@ -263,6 +263,9 @@ void drawBitmapFromSpiffs(const char *filename, int16_t x, int16_t y, bool with_
           }
         }
         display.clearScreen();
+        // rows are streamed into the controller window in file order, not on GDEW0154Z04
+        bool streamed = (display.panel() != GxEPD2::GDEW0154Z04);
+        if (streamed) display.beginImage(x, y, w, h, flip);
         uint32_t rowPosition = flip ? imageOffset + (height - h) * rowSize : imageOffset;
         for (uint16_t row = 0; row < h; row++, rowPosition += rowSize) // for each line
         {
@@ -350,9 +353,17 @@ void drawBitmapFromSpiffs(const char *filename, int16_t x, int16_t y, bool with_
               out_color_byte = 0xFF; // white (for w%8!=0 boarder)
             }
           } // end pixel
-          uint16_t yrow = y + (flip ? h - row - 1 : row);
-          display.writeImage(output_row_mono_buffer, output_row_color_buffer, x, yrow, w, 1);
+          if (streamed)
+          {
+            display.writeImageRows(output_row_mono_buffer, output_row_color_buffer, 1);
+          }
+          else
+          {
+            uint16_t yrow = y + (flip ? h - row - 1 : row);
+            display.writeImage(output_row_mono_buffer, output_row_color_buffer, x, yrow, w, 1);
+          }
         } // end line
+        if (streamed) display.endImage();
         Serial.print("loaded in "); Serial.print(millis() - startTime); Serial.println(" ms");
         display.refresh();
       }
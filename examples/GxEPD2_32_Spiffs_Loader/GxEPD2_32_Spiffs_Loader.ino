@@ -27,6 +27,8 @@ const bool formatOnFail = false;
 
 #include <WiFiClient.h>
 #include <WiFiClientSecure.h>
+#include <GxEPD2_32_HttpImageSource.h>
+#include <GxEPD2_32_ImageCache.h>
 
 const char* ssid     = "........";
 const char* password = "........";
@@ -39,6 +41,16 @@ const char* host_rawcontent   = "raw.githubusercontent.com";
 const char* path_rawcontent   = "/ZinggJM/GxEPD2/master/extras/bitmaps/";
 const char* path_prenticedavid   = "/prenticedavid/MCUFRIEND_kbv/master/extras/bitmaps/";
 
+// the connections are kept open between downloads from the same host
+WiFiClient http_client;
+WiFiClientSecure https_client;
+GxEPD2_32_HttpImageSource http_source(http_client);
+GxEPD2_32_HttpImageSource https_source(https_client);
+
+// files are downloaded only if changed on the server; keep the budget below the SPIFFS size
+const uint32_t cache_budget = 1000000;
+GxEPD2_32_ImageCache cache(SPIFFS, cache_budget);
+
 void setup()
 {
   Serial.begin(115200);
@@ -90,10 +102,12 @@ void setup()
   SPIFFS.begin();
 #endif
   Serial.println("SPIFFS started");
+  cache.begin();
   listFiles();
   //deleteFiles();
   downloadBitmaps_200x200();
   downloadBitmaps_other();
+  cache.flush();
   listFiles();
 }
 
@@ -132,6 +146,8 @@ void downloadBitmaps_other()
 
 void deleteFiles()
 {
+  cache.clear();
+  // files not in the cache, e.g. loaded by an earlier version of this example
   SPIFFS.remove("logo200x200.bmp");
   SPIFFS.remove("first200x200.bmp");
   SPIFFS.remove("second200x200.bmp");
@@ -157,79 +173,23 @@ void deleteFiles()
 
 void downloadFile_HTTP(const char* host, const char* path, const char* filename, const char* target)
 {
-  WiFiClient client;
-  Serial.print("connecting to ");
-  Serial.println(host);
-  if (!client.connect(host, httpPort))
+  Serial.println(); Serial.print("downloading file \""); Serial.print(filename);  Serial.println("\"");
+  Serial.print("connecting to "); Serial.println(host);
+  if (!http_source.connect(host, httpPort))
   {
     Serial.println("connection failed");
     return;
   }
   Serial.print("requesting URL: ");
   Serial.println(String("http://") + host + path + filename);
-  client.print(String("GET ") + path + filename + " HTTP/1.1\r\n" +
-               "Host: " + host + "\r\n" +
-               "User-Agent: GxEPD2_Spiffs_Loader\r\n" +
-               "Connection: close\r\n\r\n");
-  Serial.println("request sent");
-  bool ok = false;
-  while (client.connected())
-  {
-    String line = client.readStringUntil('\n');
-    if (!ok)
-    {
-      ok = line.startsWith("HTTP/1.1 200 OK");
-      if (ok) Serial.println(line);
-      //if (!ok) Serial.println(line);
-    }
-    if (!ok) Serial.println(line);
-    //Serial.println(line);
-    if (line == "\r")
-    {
-      Serial.println("headers received");
-      break;
-    }
-  }
-  if (!ok) return;
-  uint8_t buffer[512];
-#if defined(ESP8266)
-  client.peekBytes(buffer, 2);
-  Serial.write(buffer[0]); Serial.write(buffer[1]); Serial.println();
-#endif
-  size_t total = 0;
-#if defined(ESP32)
-  fs::File file = SPIFFS.open(String("/") + target, "w+");
-#else
-  fs::File file = SPIFFS.open(target, "w+");
-#endif
-  if (!file)
-  {
-    Serial.print(target); Serial.println(" open failed");
-    return;
-  }
-  while (client.connected())
-  {
-    size_t available = client.available();
-    size_t fetch = available <= sizeof(buffer) ? available : sizeof(buffer);
-    if (fetch > 0)
-    {
-      size_t got = client.read(buffer, fetch);
-      file.write(buffer, got);
-      total += got;
-    }
-    delay(1); // yield();
-  }
-  file.close();
-  Serial.print("done, "); Serial.print(total); Serial.println(" bytes transferred");
+  downloadFile_Source(http_source, String(path) + filename, target);
 }
 
 void downloadFile_HTTPS(const char* host, const char* path, const char* filename, const char* fingerprint, const char* target)
 {
-  // Use WiFiClientSecure class to create TLS connection
-  WiFiClientSecure client;
   Serial.println(); Serial.print("downloading file \""); Serial.print(filename);  Serial.println("\"");
   Serial.print("connecting to "); Serial.println(host);
-  if (!client.connect(host, httpsPort))
+  if (!https_source.connect(host, httpsPort))
   {
     Serial.println("connection failed");
     return;
@@ -237,94 +197,47 @@ void downloadFile_HTTPS(const char* host, const char* path, const char* filename
 #if defined (ESP8266)
   if (fingerprint)
   {
-    if (client.verify(fingerprint, host))
+    if (https_client.verify(fingerprint, host))
     {
       Serial.println("certificate matches");
     }
     else
     {
       Serial.println("certificate doesn't match");
+      https_source.stop();
       return;
     }
   }
 #endif
   Serial.print("requesting URL: ");
   Serial.println(String("https://") + host + path + filename);
-  client.print(String("GET ") + path + filename + " HTTP/1.1\r\n" +
-               "Host: " + host + "\r\n" +
-               "User-Agent: GxEPD2_Spiffs_Loader\r\n" +
-               "Connection: close\r\n\r\n");
-  Serial.println("request sent");
-  bool ok = false;
-  while (client.connected())
-  {
-    String line = client.readStringUntil('\n');
-    if (!ok)
-    {
-      ok = line.startsWith("HTTP/1.1 200 OK");
-      if (ok) Serial.println(line);
-      //if (!ok) Serial.println(line);
-    }
-    if (!ok) Serial.println(line);
-    //Serial.println(line);
-    if (line == "\r")
-    {
-      Serial.println("headers received");
-      break;
-    }
-  }
-  if (!ok) return;
-  uint8_t buffer[512];
-#if defined(ESP8266)
-  client.peekBytes(buffer, 2);
-  Serial.write(buffer[0]); Serial.write(buffer[1]); Serial.println();
-#endif
-  size_t total = 0;
+  downloadFile_Source(https_source, String(path) + filename, target);
+}
+
+void downloadFile_Source(GxEPD2_32_HttpImageSource& source, const String& url, const char* target)
+{
 #if defined(ESP32)
-  fs::File file = SPIFFS.open(String("/") + target, "w+");
+  String name = String("/") + target;
 #else
-  fs::File file = SPIFFS.open(target, "w+");
+  String name = target;
 #endif
-  if (!file)
+  fs::File file;
+  switch (cache.fetch(source, url.c_str(), name.c_str(), file))
   {
-    Serial.print(target); Serial.println(" open failed");
-    return;
-  }
-  while (client.connected())
-  {
-    // this doesn't work as expected, but it helps for long downloads
-    int32_t start = millis();
-    for (int16_t t = 0, dly = 50; t < 20; t++, dly += 50)
-    {
-      if (!client.connected()) break;
-      if (client.available()) break; // read would not recover after having returned 0
-      delay(dly);
-    }
-    if (!client.connected()) break;
-    int32_t elapsed = millis() - start;
-    if (elapsed > 250)
-    {
-      Serial.print("waited for available "); Serial.print(millis() - start); Serial.print(" ms @ "); Serial.println(total);
-    }
-    size_t available = client.available();
-    if (0 == available)
-    {
-      Serial.print("download error: timeout on available() after "); Serial.print(total); Serial.println(" bytes");
-      break; // don't hang forever
-    }
-    size_t fetch = available <= sizeof(buffer) ? available : sizeof(buffer);
-    if (fetch > 0)
-    {
-      size_t got = client.read(buffer, fetch);
-      file.write(buffer, got);
-      total += got;
-    }
-    delay(1); // yield();
-    if (total > 30000) delay(250); // helps for long downloads
+    case GxEPD2_32_ImageCache::CacheHit:
+      Serial.print("not modified, "); Serial.print(file.size()); Serial.println(" bytes in cache");
+      break;
+    case GxEPD2_32_ImageCache::CacheStored:
+      Serial.print("done, "); Serial.print(file.size()); Serial.println(" bytes transferred");
+      break;
+    case GxEPD2_32_ImageCache::CacheSkipped:
+      Serial.print(target); Serial.println(" is too large for the cache budget");
+      source.skip(source.contentLength());
+      break;
+    default:
+      Serial.print("download failed, status "); Serial.println(source.status());
+      break;
   }
-  file.close();
-  Serial.print("done, "); Serial.print(total); Serial.println(" bytes transferred");
+  if (file) file.close();
+  Serial.print("cache used "); Serial.print(cache.used()); Serial.print(" of "); Serial.println(cache.budget());
 }
-
-
-
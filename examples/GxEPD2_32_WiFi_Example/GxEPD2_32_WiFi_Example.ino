@@ -95,6 +95,7 @@
 
 #include <WiFiClient.h>
 #include <WiFiClientSecure.h>
+#include <GxEPD2_32_HttpImageSource.h>
 
 const char* ssid     = "........";
 const char* password = "........";
@@ -109,6 +110,7 @@ const char* path_prenticedavid   = "/prenticedavid/MCUFRIEND_kbv/master/extras/b
 
 void showBitmapFrom_HTTP(const char* host, const char* path, const char* filename, int16_t x, int16_t y, bool with_color = true);
 void showBitmapFrom_HTTPS(const char* host, const char* path, const char* filename, const char* fingerprint, int16_t x, int16_t y, bool with_color = true);
+void showBitmapFrom_Source(GxEPD2_32_HttpImageSource& source, const String& url, int16_t x, int16_t y, bool with_color, uint32_t startTime);
 
 void setup()
 {
@@ -268,252 +270,35 @@ uint8_t output_row_color_buffer[max_row_width / 8]; // buffer for at least one r
 uint8_t mono_palette_buffer[max_palette_pixels / 8]; // palette buffer for depth <= 8 b/w
 uint8_t color_palette_buffer[max_palette_pixels / 8]; // palette buffer for depth <= 8 c/w
 
+// the connections are kept open between downloads from the same host
+WiFiClient http_client;
+WiFiClientSecure https_client;
+GxEPD2_32_HttpImageSource http_source(http_client);
+GxEPD2_32_HttpImageSource https_source(https_client);
+
 void showBitmapFrom_HTTP(const char* host, const char* path, const char* filename, int16_t x, int16_t y, bool with_color)
 {
-  WiFiClient client;
-  bool connection_ok = false;
-  bool valid = false; // valid format to be handled
-  bool flip = true; // bitmap is stored bottom-to-top
   uint32_t startTime = millis();
   if ((x >= display.width()) || (y >= display.height())) return;
   Serial.println(); Serial.print("downloading file \""); Serial.print(filename);  Serial.println("\"");
   Serial.print("connecting to "); Serial.println(host);
-  if (!client.connect(host, httpPort))
+  if (!http_source.connect(host, httpPort))
   {
     Serial.println("connection failed");
     return;
   }
   Serial.print("requesting URL: ");
   Serial.println(String("http://") + host + path + filename);
-  client.print(String("GET ") + path + filename + " HTTP/1.1\r\n" +
-               "Host: " + host + "\r\n" +
-               "User-Agent: GxEPD2_Spiffs_Loader\r\n" +
-               "Connection: close\r\n\r\n");
-  Serial.println("request sent");
-  while (client.connected())
-  {
-    String line = client.readStringUntil('\n');
-    if (!connection_ok)
-    {
-      connection_ok = line.startsWith("HTTP/1.1 200 OK");
-      if (connection_ok) Serial.println(line);
-      //if (!connection_ok) Serial.println(line);
-    }
-    if (!connection_ok) Serial.println(line);
-    //Serial.println(line);
-    if (line == "\r")
-    {
-      Serial.println("headers received");
-      break;
-    }
-  }
-  if (!connection_ok) return;
-  // Parse BMP header
-  if (read16(client) == 0x4D42) // BMP signature
-  {
-    uint32_t fileSize = read32(client);
-    uint32_t creatorBytes = read32(client);
-    uint32_t imageOffset = read32(client); // Start of image data
-    uint32_t headerSize = read32(client);
-    uint32_t width  = read32(client);
-    uint32_t height = read32(client);
-    uint16_t planes = read16(client);
-    uint16_t depth = read16(client); // bits per pixel
-    uint32_t format = read32(client);
-    uint32_t bytes_read = 7 * 4 + 3 * 2; // read so far
-    if ((planes == 1) && ((format == 0) || (format == 3))) // uncompressed is handled, 565 also
-    {
-      Serial.print("File size: "); Serial.println(fileSize);
-      Serial.print("Image Offset: "); Serial.println(imageOffset);
-      Serial.print("Header size: "); Serial.println(headerSize);
-      Serial.print("Bit Depth: "); Serial.println(depth);
-      Serial.print("Image size: ");
-      Serial.print(width);
-      Serial.print('x');
-      Serial.println(height);
-      // BMP rows are padded (if needed) to 4-byte boundary
-      uint32_t rowSize = (width * depth / 8 + 3) & ~3;
-      if (depth < 8) rowSize = ((width * depth + 8 - depth) / 8 + 3) & ~3;
-      if (height < 0)
-      {
-        height = -height;
-        flip = false;
-      }
-      uint16_t w = width;
-      uint16_t h = height;
-      if ((x + w - 1) >= display.width())  w = display.width()  - x;
-      if ((y + h - 1) >= display.height()) h = display.height() - y;
-      if (w <= max_row_width) // handle with direct drawing
-      {
-        valid = true;
-        uint8_t bitmask = 0xFF;
-        uint8_t bitshift = 8 - depth;
-        uint16_t red, green, blue;
-        bool whitish, colored;
-        if (depth == 1) with_color = false;
-        if (depth <= 8)
-        {
-          if (depth < 8) bitmask >>= depth;
-          bytes_read += skip(client, 54 - bytes_read); //palette is always @ 54
-          for (uint16_t pn = 0; pn < (1 << depth); pn++)
-          {
-            blue  = client.read();
-            green = client.read();
-            red   = client.read();
-            client.read();
-            bytes_read += 4;
-            whitish = with_color ? ((red > 0x80) && (green > 0x80) && (blue > 0x80)) : ((red + green + blue) > 3 * 0x80); // whitish
-            colored = (red > 0xF0) || ((green > 0xF0) && (blue > 0xF0)); // reddish or yellowish?
-            if (0 == pn % 8) mono_palette_buffer[pn / 8] = 0;
-            mono_palette_buffer[pn / 8] |= whitish << pn % 8;
-            if (0 == pn % 8) color_palette_buffer[pn / 8] = 0;
-            color_palette_buffer[pn / 8] |= colored << pn % 8;
-            //Serial.print("0x00"); Serial.print(red, HEX); Serial.print(green, HEX); Serial.print(blue, HEX);
-            //Serial.print(" : "); Serial.print(whitish); Serial.print(", "); Serial.println(colored);
-          }
-        }
-        display.clearScreen();
-        uint32_t rowPosition = flip ? imageOffset + (height - h) * rowSize : imageOffset;
-        //Serial.print("skip "); Serial.println(rowPosition - bytes_read);
-        bytes_read += skip(client, rowPosition - bytes_read);
-        for (uint16_t row = 0; row < h; row++, rowPosition += rowSize) // for each line
-        {
-          if (!connection_ok || !client.connected()) break;
-          delay(1); // yield() to avoid WDT
-          uint32_t in_remain = rowSize;
-          uint32_t in_idx = 0;
-          uint32_t in_bytes = 0;
-          uint8_t in_byte = 0; // for depth <= 8
-          uint8_t in_bits = 0; // for depth <= 8
-          uint8_t out_byte = 0xFF; // white (for w%8!=0 boarder)
-          uint8_t out_color_byte = 0xFF; // white (for w%8!=0 boarder)
-          uint32_t out_idx = 0;
-          for (uint16_t col = 0; col < w; col++) // for each pixel
-          {
-            yield();
-            if (!connection_ok || !client.connected()) break;
-            // Time to read more pixel data?
-            if (in_idx >= in_bytes) // ok, exact match for 24bit also (size IS multiple of 3)
-            {
-              uint32_t get = in_remain > sizeof(input_buffer) ? sizeof(input_buffer) : in_remain;
-              //if (get > client.available()) delay(200); // does improve? yes, if >= 200
-              // there seems an issue with long downloads on ESP8266
-              tryToWaitForAvailable(client, get);
-              uint32_t got = client.read(input_buffer, get);
-              while ((got < get) && connection_ok)
-              {
-                //Serial.print("got "); Serial.print(got); Serial.print(" < "); Serial.print(get); Serial.print(" @ "); Serial.println(bytes_read);
-                //if ((get - got) > client.available()) delay(200); // does improve? yes, if >= 200
-                // there seems an issue with long downloads on ESP8266
-                tryToWaitForAvailable(client, get - got);
-                uint32_t gotmore = client.read(input_buffer + got, get - got);
-                got += gotmore;
-                connection_ok = gotmore > 0;
-              }
-              in_bytes = got;
-              in_remain -= got;
-              bytes_read += got;
-            }
-            if (!connection_ok)
-            {
-              Serial.print("Error: got no more after "); Serial.print(bytes_read); Serial.println(" bytes read!");
-              break;
-            }
-            switch (depth)
-            {
-              case 24:
-                blue = input_buffer[in_idx++];
-                green = input_buffer[in_idx++];
-                red = input_buffer[in_idx++];
-                whitish = with_color ? ((red > 0x80) && (green > 0x80) && (blue > 0x80)) : ((red + green + blue) > 3 * 0x80); // whitish
-                colored = (red > 0xF0) || ((green > 0xF0) && (blue > 0xF0)); // reddish or yellowish?
-                break;
-              case 16:
-                {
-                  uint8_t lsb = input_buffer[in_idx++];
-                  uint8_t msb = input_buffer[in_idx++];
-                  if (format == 0) // 555
-                  {
-                    blue  = (lsb & 0x1F) << 3;
-                    green = ((msb & 0x03) << 6) | ((lsb & 0xE0) >> 2);
-                    red   = (msb & 0x7C) << 1;
-                  }
-                  else // 565
-                  {
-                    blue  = (lsb & 0x1F) << 3;
-                    green = ((msb & 0x07) << 5) | ((lsb & 0xE0) >> 3);
-                    red   = (msb & 0xF8);
-                  }
-                  whitish = with_color ? ((red > 0x80) && (green > 0x80) && (blue > 0x80)) : ((red + green + blue) > 3 * 0x80); // whitish
-                  colored = (red > 0xF0) || ((green > 0xF0) && (blue > 0xF0)); // reddish or yellowish?
-                }
-                break;
-              case 1:
-              case 4:
-              case 8:
-                {
-                  if (0 == in_bits)
-                  {
-                    in_byte = input_buffer[in_idx++];
-                    in_bits = 8;
-                  }
-                  uint16_t pn = (in_byte >> bitshift) & bitmask;
-                  whitish = mono_palette_buffer[pn / 8] & (0x1 << pn % 8);
-                  colored = color_palette_buffer[pn / 8] & (0x1 << pn % 8);
-                  in_byte <<= depth;
-                  in_bits -= depth;
-                }
-                break;
-            }
-            if (whitish)
-            {
-              // keep white
-            }
-            else if (colored && with_color)
-            {
-              out_color_byte &= ~(0x80 >> col % 8); // colored
-            }
-            else
-            {
-              out_byte &= ~(0x80 >> col % 8); // black
-            }
-            if ((7 == col % 8) || (col == w - 1)) // write that last byte! (for w%8!=0 boarder)
-            {
-              output_row_color_buffer[out_idx] = out_color_byte;
-              output_row_mono_buffer[out_idx++] = out_byte;
-              out_byte = 0xFF; // white (for w%8!=0 boarder)
-              out_color_byte = 0xFF; // white (for w%8!=0 boarder)
-            }
-          } // end pixel
-          int16_t yrow = y + (flip ? h - row - 1 : row);
-          display.writeImage(output_row_mono_buffer, output_row_color_buffer, x, yrow, w, 1);
-        } // end line
-        Serial.print("downloaded in ");
-        Serial.print(millis() - startTime);
-        Serial.println(" ms");
-        display.refresh();
-      }
-      Serial.print("bytes read "); Serial.println(bytes_read);
-    }
-  }
-  if (!valid)
-  {
-    Serial.println("bitmap format not handled.");
-  }
+  showBitmapFrom_Source(http_source, String(path) + filename, x, y, with_color, startTime);
 }
 
 void showBitmapFrom_HTTPS(const char* host, const char* path, const char* filename, const char* fingerprint, int16_t x, int16_t y, bool with_color)
 {
-  // Use WiFiClientSecure class to create TLS connection
-  WiFiClientSecure client;
-  bool connection_ok = false;
-  bool valid = false; // valid format to be handled
-  bool flip = true; // bitmap is stored bottom-to-top
   uint32_t startTime = millis();
   if ((x >= display.width()) || (y >= display.height())) return;
   Serial.println(); Serial.print("downloading file \""); Serial.print(filename);  Serial.println("\"");
   Serial.print("connecting to "); Serial.println(host);
-  if (!client.connect(host, httpsPort))
+  if (!https_source.connect(host, httpsPort))
   {
     Serial.println("connection failed");
     return;
@@ -521,54 +306,47 @@ void showBitmapFrom_HTTPS(const char* host, const char* path, const char* filena
 #if defined (ESP8266)
   if (fingerprint)
   {
-    if (client.verify(fingerprint, host))
+    if (https_client.verify(fingerprint, host))
     {
       Serial.println("certificate matches");
     }
     else
     {
       Serial.println("certificate doesn't match");
+      https_source.stop();
       return;
     }
   }
 #endif
   Serial.print("requesting URL: ");
   Serial.println(String("https://") + host + path + filename);
-  client.print(String("GET ") + path + filename + " HTTP/1.1\r\n" +
-               "Host: " + host + "\r\n" +
-               "User-Agent: GxEPD2_Spiffs_Loader\r\n" +
-               "Connection: close\r\n\r\n");
-  Serial.println("request sent");
-  while (client.connected())
+  showBitmapFrom_Source(https_source, String(path) + filename, x, y, with_color, startTime);
+}
+
+void showBitmapFrom_Source(GxEPD2_32_HttpImageSource& source, const String& url, int16_t x, int16_t y, bool with_color, uint32_t startTime)
+{
+  bool valid = false; // valid format to be handled
+  bool flip = true; // bitmap is stored bottom-to-top
+  int16_t status = source.get(url.c_str());
+  bool connection_ok = (status == 200);
+  if (!connection_ok)
   {
-    String line = client.readStringUntil('\n');
-    if (!connection_ok)
-    {
-      connection_ok = line.startsWith("HTTP/1.1 200 OK");
-      if (connection_ok) Serial.println(line);
-      //if (!connection_ok) Serial.println(line);
-    }
-    if (!connection_ok) Serial.println(line);
-    //Serial.println(line);
-    if (line == "\r")
-    {
-      Serial.println("headers received");
-      break;
-    }
+    Serial.print("request failed, status "); Serial.println(status);
+    return;
   }
-  if (!connection_ok) return;
+  Serial.println("headers received");
   // Parse BMP header
-  if (read16(client) == 0x4D42) // BMP signature
+  if (source.read16() == 0x4D42) // BMP signature
   {
-    uint32_t fileSize = read32(client);
-    uint32_t creatorBytes = read32(client);
-    uint32_t imageOffset = read32(client); // Start of image data
-    uint32_t headerSize = read32(client);
-    uint32_t width  = read32(client);
-    uint32_t height = read32(client);
-    uint16_t planes = read16(client);
-    uint16_t depth = read16(client); // bits per pixel
-    uint32_t format = read32(client);
+    uint32_t fileSize = source.read32();
+    uint32_t creatorBytes = source.read32();
+    uint32_t imageOffset = source.read32(); // Start of image data
+    uint32_t headerSize = source.read32();
+    uint32_t width  = source.read32();
+    uint32_t height = source.read32();
+    uint16_t planes = source.read16();
+    uint16_t depth = source.read16(); // bits per pixel
+    uint32_t format = source.read32();
     uint32_t bytes_read = 7 * 4 + 3 * 2; // read so far
     if ((planes == 1) && ((format == 0) || (format == 3))) // uncompressed is handled, 565 also
     {
@@ -603,13 +381,13 @@ void showBitmapFrom_HTTPS(const char* host, const char* path, const char* filena
         if (depth <= 8)
         {
           if (depth < 8) bitmask >>= depth;
-          bytes_read += skip(client, 54 - bytes_read); //palette is always @ 54
+          bytes_read += source.skip(54 - bytes_read); //palette is always @ 54
           for (uint16_t pn = 0; pn < (1 << depth); pn++)
           {
-            blue  = client.read();
-            green = client.read();
-            red   = client.read();
-            client.read();
+            blue  = source.read();
+            green = source.read();
+            red   = source.read();
+            source.read();
             bytes_read += 4;
             whitish = with_color ? ((red > 0x80) && (green > 0x80) && (blue > 0x80)) : ((red + green + blue) > 3 * 0x80); // whitish
             colored = (red > 0xF0) || ((green > 0xF0) && (blue > 0xF0)); // reddish or yellowish?
@@ -622,13 +400,16 @@ void showBitmapFrom_HTTPS(const char* host, const char* path, const char* filena
           }
         }
         display.clearScreen();
+        // rows are streamed into the controller window in file order, not on GDEW0154Z04
+        bool streamed = (display.panel() != GxEPD2::GDEW0154Z04);
+        if (streamed) display.beginImage(x, y, w, h, flip);
         uint32_t rowPosition = flip ? imageOffset + (height - h) * rowSize : imageOffset;
         //Serial.print("skip "); Serial.println(rowPosition - bytes_read);
-        bytes_read += skip(client, rowPosition - bytes_read);
+        bytes_read += source.skip(rowPosition - bytes_read);
         for (uint16_t row = 0; row < h; row++, rowPosition += rowSize) // for each line
         {
-          if (!connection_ok || !client.connected()) break;
-          delay(1); // yield() to avoid WDT
+          if (!connection_ok) break;
+          yield(); // avoid WDT
           uint32_t in_remain = rowSize;
           uint32_t in_idx = 0;
           uint32_t in_bytes = 0;
@@ -639,26 +420,13 @@ void showBitmapFrom_HTTPS(const char* host, const char* path, const char* filena
           uint32_t out_idx = 0;
           for (uint16_t col = 0; col < w; col++) // for each pixel
           {
-            yield();
-            if (!connection_ok || !client.connected()) break;
             // Time to read more pixel data?
             if (in_idx >= in_bytes) // ok, exact match for 24bit also (size IS multiple of 3)
             {
               uint32_t get = in_remain > sizeof(input_buffer) ? sizeof(input_buffer) : in_remain;
-              //if (get > client.available()) delay(200); // does improve? yes, if >= 200
-              // there seems an issue with long downloads on ESP8266
-              tryToWaitForAvailable(client, get);
-              uint32_t got = client.read(input_buffer, get);
-              while ((got < get) && connection_ok)
-              {
-                //Serial.print("got "); Serial.print(got); Serial.print(" < "); Serial.print(get); Serial.print(" @ "); Serial.println(bytes_read);
-                if ((get - got) > client.available()) delay(200); // does improve? yes, if >= 200
-                // there seems an issue with long downloads on ESP8266
-                tryToWaitForAvailable(client, get - got);
-                uint32_t gotmore = client.read(input_buffer + got, get - got);
-                got += gotmore;
-                connection_ok = gotmore > 0;
-              }
+              uint32_t got = source.read(input_buffer, get); // waits up to the timeout of the source
+              connection_ok = (got == get);
+              in_idx = 0;
               in_bytes = got;
               in_remain -= got;
               bytes_read += got;
@@ -734,13 +502,23 @@ void showBitmapFrom_HTTPS(const char* host, const char* path, const char* filena
               out_color_byte = 0xFF; // white (for w%8!=0 boarder)
             }
           } // end pixel
-          int16_t yrow = y + (flip ? h - row - 1 : row);
-          display.writeImage(output_row_mono_buffer, output_row_color_buffer, x, yrow, w, 1);
+          if (streamed)
+          {
+            display.writeImageRows(output_row_mono_buffer, output_row_color_buffer, 1);
+          }
+          else
+          {
+            int16_t yrow = y + (flip ? h - row - 1 : row);
+            display.writeImage(output_row_mono_buffer, output_row_color_buffer, x, yrow, w, 1);
+          }
         } // end line
-        Serial.print("downloaded in "); Serial.print(millis() - startTime); Serial.println(" ms");
-        Serial.print("bytes read "); Serial.println(bytes_read);
+        if (streamed) display.endImage();
+        Serial.print("downloaded in ");
+        Serial.print(millis() - startTime);
+        Serial.println(" ms");
         display.refresh();
       }
+      Serial.print("bytes read "); Serial.println(bytes_read);
     }
   }
   if (!valid)
@@ -748,72 +526,3 @@ void showBitmapFrom_HTTPS(const char* host, const char* path, const char* filena
     Serial.println("bitmap format not handled.");
   }
 }
-
-uint16_t read16(WiFiClient& client)
-{
-  // BMP data is stored little-endian, same as Arduino.
-  uint16_t result;
-  ((uint8_t *)&result)[0] = client.read(); // LSB
-  ((uint8_t *)&result)[1] = client.read(); // MSB
-  return result;
-}
-
-uint32_t read32(WiFiClient& client)
-{
-  // BMP data is stored little-endian, same as Arduino.
-  uint32_t result;
-  ((uint8_t *)&result)[0] = client.read(); // LSB
-  ((uint8_t *)&result)[1] = client.read();
-  ((uint8_t *)&result)[2] = client.read();
-  ((uint8_t *)&result)[3] = client.read(); // MSB
-  return result;
-}
-
-uint32_t skip(WiFiClient& client, int32_t bytes)
-{
-  int32_t remain = bytes;
-  int16_t retries = 3;
-  uint32_t chunk = 1024;
-  if (chunk > sizeof(input_buffer)) chunk = sizeof(input_buffer);
-  while (client.connected() && (remain > chunk))
-  {
-    // there seems an issue with long downloads on ESP8266
-    tryToWaitForAvailable(client, chunk);
-    uint32_t got = client.read(input_buffer, chunk);
-    //Serial.print("skipped "); Serial.println(got);
-    remain -= got;
-    if ((0 == got) && (0 == --retries))
-    {
-      Serial.print("Error on skip, got 0, skipped "); Serial.print(bytes - remain); Serial.print(" of "); Serial.println(bytes);
-      break; // don't hang forever (retries don't help)
-    }
-  }
-  if (client.connected() && (remain > 0) && (remain <= chunk))
-  {
-    remain -= client.read(input_buffer, remain);
-  }
-  return bytes - remain; // bytes read and skipped
-}
-
-void tryToWaitForAvailable(WiFiClient& client, int32_t amount)
-{
-  // this doesn't work as expected, but it helps for long downloads
-  int32_t start = millis();
-  for (int16_t t = 0, dly = 50; t < 20; t++, dly += 50)
-  {
-    if (client.available()) break; // read would not recover after having returned 0
-    delay(dly);
-  }
-  for (int16_t t = 0, dly = 50; t < 3; t++, dly += 25)
-  {
-    if (amount <= client.available()) break;
-    delay(dly);
-    //Serial.print("available "); Serial.println(client.available()); // stays constant
-  }
-  int32_t elapsed = millis() - start;
-  if (elapsed > 250)
-  {
-    Serial.print("waited for available "); Serial.print(millis() - start); Serial.println(" ms");
-  }
-}
-
@@ -0,0 +1,28 @@
+// Checks for the host tests in extras/host: failures are printed, the count is the exit code.
+
+#ifndef _HostTest_H_
+#define _HostTest_H_
+
+#include <stdio.h>
+
+static int host_checks = 0, host_failures = 0;
+
+#define CHECK(condition) \
+  do \
+  { \
+    host_checks++; \
+    if (!(condition)) \
+    { \
+      host_failures++; \
+      printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+    } \
+  } \
+  while (0)
+
+static int hostTestResult(const char* name)
+{
+  printf("%s: %d checks, %d failed\n", name, host_checks, host_failures);
+  return host_failures ? 1 : 0;
+}
+
+#endif
@@ -0,0 +1,97 @@
+// Scripted Client for the host tests in extras/host: each request, up to its empty line, goes to a handler,
+// which returns the response; the response is read in pieces of at most piece bytes, to split lines and chunks.
+
+#ifndef _MockClient_H_
+#define _MockClient_H_
+
+#include <Client.h>
+#include <functional>
+#include <string>
+
+class MockClient : public Client
+{
+  public:
+    // returns the response to request; close: the server closes the connection after the response
+    typedef std::function<std::string(const std::string& request, bool& close)> Handler;
+    MockClient(Handler handler, size_t piece = 61) :
+      connects(0), requests(0), drop_requests(0), _handler(handler), _piece(piece), _rx_pos(0), _open(false), _closing(false) {}
+    int connect(const char* host, uint16_t port)
+    {
+      (void) host;
+      (void) port;
+      stop();
+      _open = true;
+      connects++;
+      return 1;
+    }
+    size_t write(uint8_t c)
+    {
+      return write(&c, 1);
+    }
+    size_t write(const uint8_t* buf, size_t size)
+    {
+      if (!_open || _closing) return 0;
+      _tx.append(reinterpret_cast<const char*>(buf), size);
+      size_t end;
+      while ((end = _tx.find("\r\n\r\n")) != std::string::npos)
+      {
+        std::string request = _tx.substr(0, end + 4);
+        _tx.erase(0, end + 4);
+        requests++;
+        if (drop_requests > 0)
+        {
+          // the server has closed the kept connection meanwhile
+          drop_requests--;
+          _closing = true;
+          break;
+        }
+        last_request = request;
+        bool close = false;
+        _rx += _handler(request, close);
+        if (close) _closing = true;
+      }
+      return size;
+    }
+    int available()
+    {
+      if (!_open) return 0;
+      size_t remaining = _rx.size() - _rx_pos;
+      return remaining < _piece ? remaining : _piece;
+    }
+    int read()
+    {
+      uint8_t c;
+      return (read(&c, 1) == 1) ? c : -1;
+    }
+    int read(uint8_t* buf, size_t size)
+    {
+      size_t n = available();
+      if (n > size) n = size;
+      memcpy(buf, _rx.data() + _rx_pos, n);
+      _rx_pos += n;
+      return n;
+    }
+    void stop()
+    {
+      _open = false;
+      _closing = false;
+      _rx.clear();
+      _rx_pos = 0;
+      _tx.clear();
+    }
+    uint8_t connected()
+    {
+      return _open && !(_closing && (_rx_pos == _rx.size()));
+    }
+    int connects, requests;
+    int drop_requests; // next requests closed without response
+    std::string last_request;
+  private:
+    Handler _handler;
+    size_t _piece;
+    std::string _rx, _tx;
+    size_t _rx_pos;
+    bool _open, _closing;
+};
+
+#endif
@@ -0,0 +1,189 @@
+// Host benchmark of the rendering and transfer paths, for every panel in GxEPD2::ScreenDimensions.
+// Built with the minimal Arduino/SPI/Adafruit_GFX shim in shim/, see Makefile; CSV on stdout:
+// panel,operation,rotation,iterations,total_us,bytes
+// bytes are the SPI bytes of the operation, counted by the shim; BUSY is idle at once and delay() returns at once,
+// so the times are the host CPU time of the library code, to compare between revisions, not device times.
+// send8pixel and bw2grey time the pixel expansion alone, for the panels that use it, on one screen of data.
+
+#include <GxEPD2_32_BW.h>
+#include <GxEPD2_32_3C.h>
+
+#include "bitmaps/Bitmaps200x200.h"
+#include "bitmaps/Bitmaps128x250.h"
+#include "bitmaps/Bitmaps128x296.h"
+#include "bitmaps/Bitmaps176x264.h"
+#include "bitmaps/Bitmaps400x300.h"
+#include "bitmaps/Bitmaps640x384.h"
+#include "bitmaps/Bitmaps3c200x200.h"
+#include "bitmaps/Bitmaps3c104x212.h"
+#include "bitmaps/Bitmaps3c128x296.h"
+#include "bitmaps/Bitmaps3c176x264.h"
+#include "bitmaps/Bitmaps3c400x300.h"
+
+static const char* panel_names[] =
+{
+  "GDEP015OC1", "GDE0213B1", "GDEH029A1", "GDEW027W3", "GDEW042T2", "GDEW075T8",
+  "GDEW0154Z04", "GDEW0213Z16", "GDEW029Z10", "GDEW027C44", "GDEW042Z15", "GDEW075Z09"
+};
+
+// bundled bitmap of the panel size, by panel; there is no 3-color 640x384 bitmap, the b/w one is used as black
+static const uint8_t* const black_bitmaps[] =
+{
+  logo200x200, logo128x250, logo128x296, Bitmap176x264_1, Bitmap400x300_1, Bitmap640x384_1,
+  Bitmap3c200x200_black, Bitmap3c104x212_1_black, Bitmap3c128x296_1_black, Bitmap3c176x264_black, Bitmap3c400x300_1_black, Bitmap640x384_1
+};
+
+static const uint8_t* const red_bitmaps[] =
+{
+  0, 0, 0, 0, 0, 0,
+  Bitmap3c200x200_red, Bitmap3c104x212_1_red, Bitmap3c128x296_1_red, Bitmap3c176x264_red, Bitmap3c400x300_1_red, 0
+};
+
+static const uint8_t expand_repeats = 10; // screens per send8pixel and bw2grey row
+
+class GxEPD2_32_HostBenchmark
+{
+  public:
+    static void run()
+    {
+      printf("panel,operation,rotation,iterations,total_us,bytes\n");
+      for (uint8_t p = GxEPD2::GDEP015OC1; p <= GxEPD2::GDEW075T8; p++)
+      {
+        GxEPD2_32_BW* bw = new GxEPD2_32_BW(GxEPD2::Panel(p), -1, -1, -1, -1);
+        benchmarkGFX(GxEPD2::Panel(p), *bw);
+        delete bw;
+        bw = new GxEPD2_32_BW(GxEPD2::Panel(p), cs, dc, rst, busy);
+        host_pin_levels[busy] = !bw->_busy_active_level;
+        bw->init();
+        benchmarkDisplay(*bw);
+        if (p == GxEPD2::GDEW075T8) benchmarkSend8pixel(*bw);
+        bw->powerOff();
+        delete bw;
+      }
+      for (uint8_t p = GxEPD2::GDEW0154Z04; p <= GxEPD2::GDEW075Z09; p++)
+      {
+        GxEPD2_32_3C* c3 = new GxEPD2_32_3C(GxEPD2::Panel(p), -1, -1, -1, -1);
+        benchmarkGFX(GxEPD2::Panel(p), *c3);
+        delete c3;
+        c3 = new GxEPD2_32_3C(GxEPD2::Panel(p), cs, dc, rst, busy);
+        host_pin_levels[busy] = !c3->_busy_active_level;
+        c3->init();
+        benchmarkDisplay(*c3);
+        if (p == GxEPD2::GDEW0154Z04) benchmarkBw2grey(*c3);
+        if (p == GxEPD2::GDEW075Z09) benchmarkSend8pixel(*c3);
+        c3->powerOff();
+        delete c3;
+      }
+    }
+  private:
+    static const int8_t cs = 10, dc = 9, rst = 8, busy = 7;
+    static void report(GxEPD2::Panel panel, const char* operation, int16_t rotation, uint32_t iterations, uint32_t total_us, uint32_t bytes)
+    {
+      printf("%s,%s,%d,%lu,%lu,%lu\n", panel_names[panel], operation, rotation,
+             (unsigned long) iterations, (unsigned long) total_us, (unsigned long) bytes);
+    }
+    static void benchmarkGFX(GxEPD2::Panel panel, Adafruit_GFX& gfx)
+    {
+      for (uint8_t r = 0; r < 4; r++)
+      {
+        gfx.setRotation(r);
+        uint16_t w = gfx.width(), h = gfx.height();
+        uint32_t start = micros();
+        for (uint16_t y = 0; y < h; y++)
+        {
+          for (uint16_t x = 0; x < w; x++)
+          {
+            gfx.drawPixel(x, y, (x + y) & 1 ? GxEPD_BLACK : GxEPD_WHITE);
+          }
+        }
+        report(panel, "drawPixel", r, uint32_t(w) * h, micros() - start, 0);
+      }
+      gfx.setRotation(0);
+      uint32_t start = micros();
+      for (uint8_t i = 0; i < 10; i++)
+      {
+        gfx.fillScreen(i & 1 ? GxEPD_BLACK : GxEPD_WHITE);
+      }
+      report(panel, "fillScreen", 0, 10, micros() - start, 0);
+    }
+    template <class Display> static void drawContent(Display& display)
+    {
+      display.fillScreen(GxEPD_WHITE);
+      display.fillRect(10, 40, display.width() / 2, 20, display.hasColor() ? GxEPD_RED : GxEPD_BLACK);
+      display.fillRect(display.width() / 4, display.height() / 2, display.width() / 2, 8, GxEPD_BLACK);
+    }
+    template <class Display> static void benchmarkPictureLoop(Display& display, const char* operation)
+    {
+      uint32_t bytes = SPI.transferred;
+      uint32_t start = micros();
+      uint16_t pages = 0;
+      display.firstPage();
+      do
+      {
+        drawContent(display);
+        pages++;
+      }
+      while (display.nextPage());
+      report(display.panel(), operation, display.getRotation(), pages, micros() - start, SPI.transferred - bytes);
+    }
+    template <class Display> static void benchmarkDisplay(Display& display)
+    {
+      GxEPD2::Panel panel = display.panel();
+      display.setRotation(0);
+      display.setFullWindow();
+      benchmarkPictureLoop(display, "full_picture_loop");
+      if (display.hasPartialUpdate())
+      {
+        display.setPartialWindow(0, 0, display.width(), display.height() / 4);
+        benchmarkPictureLoop(display, "partial_picture_loop");
+      }
+      // bundled bitmap of the panel size, no refresh
+      uint32_t bytes = SPI.transferred;
+      uint32_t start = micros();
+      display.writeImage(black_bitmaps[panel], red_bitmaps[panel], 0, 0, display.width(), display.height(), false, false, true);
+      report(panel, "writeImage", 0, 1, micros() - start, SPI.transferred - bytes);
+    }
+    static void benchmarkSend8pixel(GxEPD2_32_BW& display)
+    {
+      const uint8_t* data = black_bitmaps[display.panel()];
+      uint32_t n = uint32_t(display.WIDTH) * display.HEIGHT / 8;
+      uint32_t bytes = SPI.transferred;
+      uint32_t start = micros();
+      for (uint8_t r = 0; r < expand_repeats; r++)
+      {
+        for (uint32_t i = 0; i < n; i++) display._send8pixel(data[i]);
+      }
+      report(display.panel(), "send8pixel", 0, expand_repeats * n, micros() - start, SPI.transferred - bytes);
+    }
+    static void benchmarkSend8pixel(GxEPD2_32_3C& display)
+    {
+      const uint8_t* data = black_bitmaps[display.panel()];
+      uint32_t n = uint32_t(display.WIDTH) * display.HEIGHT / 8;
+      uint32_t bytes = SPI.transferred;
+      uint32_t start = micros();
+      for (uint8_t r = 0; r < expand_repeats; r++)
+      {
+        for (uint32_t i = 0; i < n; i++) display._send8pixel(data[i], ~data[i]);
+      }
+      report(display.panel(), "send8pixel", 0, expand_repeats * n, micros() - start, SPI.transferred - bytes);
+    }
+    static void benchmarkBw2grey(GxEPD2_32_3C& display)
+    {
+      // in rows, as _writeScreenBuffer() and writeImage() send them
+      const uint8_t* data = black_bitmaps[display.panel()];
+      uint16_t wb = display.WIDTH / 8;
+      uint32_t bytes = SPI.transferred;
+      uint32_t start = micros();
+      for (uint8_t r = 0; r < expand_repeats; r++)
+      {
+        for (uint16_t y = 0; y < display.HEIGHT; y++) display._writeDataGrey(data + y * wb, wb);
+      }
+      report(display.panel(), "bw2grey", 0, uint32_t(expand_repeats) * wb * display.HEIGHT, micros() - start, SPI.transferred - bytes);
+    }
+};
+
+int main()
+{
+  GxEPD2_32_HostBenchmark::run();
+  return 0;
+}
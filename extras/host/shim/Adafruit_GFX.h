@@ -0,0 +1,76 @@
+// Minimal Adafruit_GFX for the host build in extras/host: geometry, rotation and rectangles, no text.
+
+#ifndef _HOST_Adafruit_GFX_H_
+#define _HOST_Adafruit_GFX_H_
+
+#include <Arduino.h>
+
+typedef struct GFXfont GFXfont;
+
+class Adafruit_GFX : public Print
+{
+  public:
+    Adafruit_GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h), _width(w), _height(h), rotation(0) {}
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+    virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+    {
+      for (int16_t j = y; j < y + h; j++)
+      {
+        for (int16_t i = x; i < x + w; i++) drawPixel(i, j, color);
+      }
+    }
+    virtual void fillScreen(uint16_t color)
+    {
+      fillRect(0, 0, _width, _height, color);
+    }
+    virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+    {
+      fillRect(x, y, w, 1, color);
+    }
+    virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+    {
+      fillRect(x, y, 1, h, color);
+    }
+    virtual void setRotation(uint8_t r)
+    {
+      rotation = r & 3;
+      _width = (rotation & 1) ? HEIGHT : WIDTH;
+      _height = (rotation & 1) ? WIDTH : HEIGHT;
+    }
+    uint8_t getRotation() const
+    {
+      return rotation;
+    }
+    int16_t width() const
+    {
+      return _width;
+    }
+    int16_t height() const
+    {
+      return _height;
+    }
+    void setFont(const GFXfont* f)
+    {
+      (void) f;
+    }
+    void setCursor(int16_t x, int16_t y)
+    {
+      (void) x;
+      (void) y;
+    }
+    void setTextColor(uint16_t c)
+    {
+      (void) c;
+    }
+    size_t write(uint8_t c)
+    {
+      (void) c;
+      return 1;
+    }
+  protected:
+    const int16_t WIDTH, HEIGHT;
+    int16_t _width, _height;
+    uint8_t rotation;
+};
+
+#endif
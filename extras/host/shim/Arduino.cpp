@@ -0,0 +1,72 @@
+// Minimal Arduino core for the host build in extras/host.
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <chrono>
+
+HostSerial Serial;
+SPIClass SPI;
+uint8_t host_pin_levels[host_pins];
+
+void pinMode(int pin, int mode)
+{
+  (void) pin;
+  (void) mode;
+}
+
+void digitalWrite(int pin, int level)
+{
+  if ((pin >= 0) && (pin < host_pins)) host_pin_levels[pin] = level;
+}
+
+int digitalRead(int pin)
+{
+  return ((pin >= 0) && (pin < host_pins)) ? host_pin_levels[pin] : LOW;
+}
+
+void delay(unsigned long ms)
+{
+  (void) ms;
+}
+
+unsigned long micros()
+{
+  static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+unsigned long millis()
+{
+  return micros() / 1000;
+}
+
+void yield()
+{
+}
+
+size_t Print::print(const char* s)
+{
+  size_t n = 0;
+  while (*s) n += write(*s++);
+  return n;
+}
+
+size_t Print::print(char c)
+{
+  return write(c);
+}
+
+size_t Print::print(unsigned long n, int base)
+{
+  char buf[24];
+  snprintf(buf, sizeof(buf), (base == HEX) ? "%lX" : "%lu", n);
+  return print(buf);
+}
+
+size_t Print::print(long n, int base)
+{
+  char buf[24];
+  if (base == HEX) snprintf(buf, sizeof(buf), "%lX", (unsigned long) n);
+  else snprintf(buf, sizeof(buf), "%ld", n);
+  return print(buf);
+}
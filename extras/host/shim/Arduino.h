@@ -0,0 +1,86 @@
+// Minimal Arduino core for the host build in extras/host, only what the library uses.
+// Pins are levels in host_pin_levels[]; delay() returns at once, micros() and millis() are the host clock.
+// Serial writes to stderr, stdout is left to the programs.
+
+#ifndef _HOST_Arduino_H_
+#define _HOST_Arduino_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#define HIGH 0x1
+#define LOW  0x0
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define MSBFIRST 1
+#define SPI_MODE0 0x00
+#define DEC 10
+#define HEX 16
+
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) (*(const uint16_t*)(addr))
+
+typedef uint8_t byte;
+
+static const uint8_t host_pins = 64;
+extern uint8_t host_pin_levels[host_pins];
+
+void pinMode(int pin, int mode);
+void digitalWrite(int pin, int level);
+int digitalRead(int pin);
+void delay(unsigned long ms);
+unsigned long micros();
+unsigned long millis();
+void yield();
+
+class Print
+{
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    size_t print(const char* s);
+    size_t print(char c);
+    size_t print(unsigned long n, int base = DEC);
+    size_t print(long n, int base = DEC);
+    size_t print(unsigned int n, int base = DEC)
+    {
+      return print((unsigned long) n, base);
+    }
+    size_t print(int n, int base = DEC)
+    {
+      return print((long) n, base);
+    }
+    size_t println()
+    {
+      return write('\n');
+    }
+    template <class T> size_t println(T v)
+    {
+      return print(v) + println();
+    }
+    template <class T> size_t println(T v, int base)
+    {
+      return print(v, base) + println();
+    }
+};
+
+class HostSerial : public Print
+{
+  public:
+    void begin(unsigned long baud)
+    {
+      (void) baud;
+    }
+    size_t write(uint8_t c)
+    {
+      return fputc(c, stderr) == EOF ? 0 : 1;
+    }
+};
+
+extern HostSerial Serial;
+
+#endif
@@ -0,0 +1,21 @@
+// Minimal Arduino Client for the host build in extras/host, the interface network clients implement.
+
+#ifndef _HOST_Client_H_
+#define _HOST_Client_H_
+
+#include <Arduino.h>
+
+class Client : public Print
+{
+  public:
+    virtual int connect(const char* host, uint16_t port) = 0;
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buf, size_t size) = 0;
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int read(uint8_t* buf, size_t size) = 0;
+    virtual void stop() = 0;
+    virtual uint8_t connected() = 0;
+};
+
+#endif
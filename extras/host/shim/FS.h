@@ -0,0 +1,82 @@
+// Minimal fs::FS for the host build in extras/host: files in memory, by path.
+
+#ifndef _HOST_FS_H_
+#define _HOST_FS_H_
+
+#include <Arduino.h>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace fs
+{
+  class File
+  {
+    public:
+      File() : _pos(0) {}
+      File(std::shared_ptr<std::string> data) : _data(data), _pos(0) {}
+      operator bool() const
+      {
+        return bool(_data);
+      }
+      size_t write(const uint8_t* buf, size_t size)
+      {
+        if (!_data) return 0;
+        _data->append(reinterpret_cast<const char*>(buf), size);
+        return size;
+      }
+      size_t write(uint8_t c)
+      {
+        return write(&c, 1);
+      }
+      size_t read(uint8_t* buf, size_t size)
+      {
+        if (!_data) return 0;
+        size_t n = _data->size() - _pos;
+        if (n > size) n = size;
+        memcpy(buf, _data->data() + _pos, n);
+        _pos += n;
+        return n;
+      }
+      int read()
+      {
+        uint8_t c;
+        return (read(&c, 1) == 1) ? c : -1;
+      }
+      size_t size() const
+      {
+        return _data ? _data->size() : 0;
+      }
+      void close()
+      {
+        _data.reset();
+        _pos = 0;
+      }
+    private:
+      std::shared_ptr<std::string> _data;
+      size_t _pos;
+  };
+
+  class FS
+  {
+    public:
+      // mode "r" or "w"; "w" creates or truncates
+      File open(const char* path, const char* mode = "r")
+      {
+        if (mode[0] == 'w') return File(files[path] = std::make_shared<std::string>());
+        std::map<std::string, std::shared_ptr<std::string>>::iterator it = files.find(path);
+        return (it != files.end()) ? File(it->second) : File();
+      }
+      bool exists(const char* path)
+      {
+        return files.count(path) > 0;
+      }
+      bool remove(const char* path)
+      {
+        return files.erase(path) > 0;
+      }
+      std::map<std::string, std::shared_ptr<std::string>> files; // by path, open files keep their content
+  };
+}
+
+#endif
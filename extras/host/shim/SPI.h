@@ -0,0 +1,32 @@
+// Minimal SPI for the host build in extras/host: transfers are counted, not sent.
+
+#ifndef _HOST_SPI_H_
+#define _HOST_SPI_H_
+
+#include <Arduino.h>
+
+class SPIClass
+{
+  public:
+    SPIClass() : transferred(0) {}
+    void begin() {}
+    void end() {}
+    void setDataMode(uint8_t mode)
+    {
+      (void) mode;
+    }
+    void setBitOrder(uint8_t order)
+    {
+      (void) order;
+    }
+    uint8_t transfer(uint8_t data)
+    {
+      transferred++;
+      return data;
+    }
+    uint32_t transferred; // bytes since start
+};
+
+extern SPIClass SPI;
+
+#endif
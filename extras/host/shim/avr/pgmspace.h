@@ -0,0 +1,3 @@
+// Minimal avr/pgmspace.h for the host build in extras/host, program memory is plain memory.
+
+#include <Arduino.h>
@@ -0,0 +1,161 @@
+// Host test of GxEPD2_32_ImageCache on an in-memory fs::FS, with a scripted server, see MockClient.h:
+// conditional fetch with ETag and Last-Modified, 304 hits, modified images, LRU eviction within the budget,
+// bodies too large for the budget, index reload, entries of incomplete files dropped with their file.
+
+#include <GxEPD2_32_ImageCache.h>
+#include "MockClient.h"
+#include "HostTest.h"
+
+static std::map<std::string, unsigned> versions; // of the image at a path, changed by the tests
+
+static uint8_t bodyByte(uint32_t i, uint8_t seed)
+{
+  return uint8_t(i * 7 + seed);
+}
+
+// paths: /etag/<n>, /lm/<n>, /chunked/<n>, /nf; the body depends on the version of the path
+static std::string serve(const std::string& request, bool& close)
+{
+  (void) close;
+  char kind[16] = "", path[64] = "";
+  unsigned n = 0;
+  sscanf(request.c_str(), "GET %63s", path);
+  sscanf(path, "/%15[a-z]/%u", kind, &n);
+  unsigned version = versions[path];
+  std::string body;
+  for (uint32_t i = 0; i < n; i++) body += char(bodyByte(i, version));
+  char etag[32], last_modified[48], head[200];
+  snprintf(etag, sizeof(etag), "\"%s-%u\"", kind, version);
+  snprintf(last_modified, sizeof(last_modified), "Mon, 19 Oct 2026 10:00:%02u GMT", version % 60);
+  if (request.find(std::string("If-None-Match: ") + etag + "\r\n") != std::string::npos) return "HTTP/1.1 304 Not Modified\r\n\r\n";
+  if (!strcmp(kind, "etag"))
+  {
+    snprintf(head, sizeof(head), "HTTP/1.1 200 OK\r\nETag: %s\r\nContent-Length: %u\r\n\r\n", etag, n);
+    return head + body;
+  }
+  if (!strcmp(kind, "lm"))
+  {
+    if (request.find(std::string("If-Modified-Since: ") + last_modified + "\r\n") != std::string::npos) return "HTTP/1.1 304 Not Modified\r\n\r\n";
+    snprintf(head, sizeof(head), "HTTP/1.1 200 OK\r\nLast-Modified: %s\r\nContent-Length: %u\r\n\r\n", last_modified, n);
+    return head + body;
+  }
+  if (!strcmp(kind, "chunked"))
+  {
+    snprintf(head, sizeof(head), "HTTP/1.1 200 OK\r\nETag: %s\r\nTransfer-Encoding: chunked\r\n\r\n", etag);
+    std::string r = head;
+    for (uint32_t i = 0; i < n; i += 1000)
+    {
+      uint32_t m = (n - i < 1000) ? n - i : 1000;
+      snprintf(head, sizeof(head), "%x\r\n", m);
+      r += head + body.substr(i, m) + "\r\n";
+    }
+    return r + "0\r\n\r\n";
+  }
+  return "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n";
+}
+
+// the file is open on the image of n bytes of the version
+static bool fileIs(fs::File& file, uint32_t n, unsigned version)
+{
+  bool ok = file && (file.size() == n);
+  for (uint32_t i = 0; ok && (i < n); i++) ok = (file.read() == bodyByte(i, version));
+  file.close();
+  return ok;
+}
+
+int main()
+{
+  MockClient client(serve);
+  GxEPD2_32_HttpImageSource source(client);
+  fs::FS fs;
+  const uint32_t budget = 10000;
+  GxEPD2_32_ImageCache cache(fs, budget);
+  fs::File file;
+  cache.begin();
+  CHECK(cache.used() == 0);
+  CHECK(source.connect("host.test", 80));
+
+  // stored on the first fetch, then revalidated with its ETag
+  CHECK(cache.fetch(source, "/etag/3000", "/a.bmp", file) == GxEPD2_32_ImageCache::CacheStored);
+  CHECK(fileIs(file, 3000, 0));
+  CHECK(cache.used() == 3000);
+  CHECK(cache.fetch(source, "/etag/3000", "/a.bmp", file) == GxEPD2_32_ImageCache::CacheHit);
+  CHECK(client.last_request.find("If-None-Match: \"etag-0\"\r\n") != std::string::npos);
+  CHECK(fileIs(file, 3000, 0));
+
+  // revalidated with its Last-Modified
+  CHECK(cache.fetch(source, "/lm/4000", "/b.bmp", file) == GxEPD2_32_ImageCache::CacheStored);
+  CHECK(fileIs(file, 4000, 0));
+  CHECK(cache.fetch(source, "/lm/4000", "/b.bmp", file) == GxEPD2_32_ImageCache::CacheHit);
+  CHECK(client.last_request.find("If-Modified-Since: Mon, 19 Oct 2026 10:00:00 GMT\r\n") != std::string::npos);
+  CHECK(fileIs(file, 4000, 0));
+  CHECK(cache.used() == 7000);
+
+  // modified on the server: downloaded again
+  versions["/etag/3000"] = 1;
+  CHECK(cache.fetch(source, "/etag/3000", "/a.bmp", file) == GxEPD2_32_ImageCache::CacheStored);
+  CHECK(fileIs(file, 3000, 1));
+  CHECK(cache.used() == 7000);
+
+  // chunked, size known after the download
+  CHECK(cache.fetch(source, "/chunked/2500", "/c.bmp", file) == GxEPD2_32_ImageCache::CacheStored);
+  CHECK(fileIs(file, 2500, 0));
+  CHECK(cache.used() == 9500);
+  CHECK(client.connects == 1);
+
+  // the least recently used image makes room: b, after a hit on a
+  CHECK(cache.fetch(source, "/etag/3000", "/a.bmp", file) == GxEPD2_32_ImageCache::CacheHit);
+  file.close();
+  CHECK(cache.fetch(source, "/etag/2000", "/d.bmp", file) == GxEPD2_32_ImageCache::CacheStored);
+  file.close();
+  CHECK(!fs.exists("/b.bmp"));
+  CHECK(fs.exists("/a.bmp") && fs.exists("/c.bmp") && fs.exists("/d.bmp"));
+  CHECK(cache.used() == 7500);
+
+  // larger than the budget: not stored, the body is left to be read from the source
+  CHECK(cache.fetch(source, "/etag/20000", "/e.bmp", file) == GxEPD2_32_ImageCache::CacheSkipped);
+  CHECK(!file);
+  CHECK(source.skip(0xFFFFFFFF) == 20000);
+  CHECK(!fs.exists("/e.bmp"));
+  // chunked and larger than the budget: known after the download, the file is removed
+  CHECK(cache.fetch(source, "/chunked/12000", "/f.bmp", file) == GxEPD2_32_ImageCache::CacheFailed);
+  CHECK(!fs.exists("/f.bmp"));
+  CHECK(cache.used() == 7500);
+
+  // failures
+  CHECK(cache.fetch(source, "/nf", "/g.bmp", file) == GxEPD2_32_ImageCache::CacheFailed);
+  CHECK(!fs.exists("/g.bmp"));
+  CHECK(cache.fetch(source, "/etag/10", "/a_name_longer_than_the_entry_has.bmp", file) == GxEPD2_32_ImageCache::CacheFailed);
+
+  // reload from the index, the use order included
+  cache.flush();
+  GxEPD2_32_ImageCache reloaded(fs, budget);
+  reloaded.begin();
+  CHECK(reloaded.used() == 7500);
+  CHECK(reloaded.fetch(source, "/chunked/2500", "/c.bmp", file) == GxEPD2_32_ImageCache::CacheHit);
+  CHECK(fileIs(file, 2500, 0));
+  CHECK(reloaded.fetch(source, "/lm/4000", "/b.bmp", file) == GxEPD2_32_ImageCache::CacheStored);
+  file.close();
+  CHECK(!fs.exists("/a.bmp")); // the least recently used before the hit on c
+  CHECK(fs.exists("/c.bmp") && fs.exists("/d.bmp"));
+  CHECK(reloaded.used() == 8500);
+  reloaded.flush();
+
+  // an incomplete file, e.g. after a reset during a download, is dropped from the index and removed
+  fs.files["/b.bmp"]->resize(100);
+  fs.remove("/c.bmp");
+  GxEPD2_32_ImageCache checked(fs, budget);
+  checked.begin();
+  CHECK(checked.used() == 2000);
+  CHECK(!fs.exists("/b.bmp"));
+  CHECK(checked.fetch(source, "/etag/2000", "/d.bmp", file) == GxEPD2_32_ImageCache::CacheHit);
+  CHECK(fileIs(file, 2000, 0));
+
+  // clear() leaves the index only
+  checked.clear();
+  CHECK(checked.used() == 0);
+  CHECK(fs.files.size() == 1);
+  CHECK(fs.exists("/gxepd2_cache.idx"));
+
+  return hostTestResult("test_cache");
+}
@@ -0,0 +1,182 @@
+// Host test of GxEPD2_32_HttpImageSource against a scripted server, see MockClient.h:
+// Content-Length and chunked bodies larger than the ring buffer, body until close, keep-alive,
+// reconnect once after the server has closed the kept connection, 304 without body, header parsing.
+
+#include <GxEPD2_32_HttpImageSource.h>
+#include "MockClient.h"
+#include "HostTest.h"
+
+static uint8_t bodyByte(uint32_t i, uint8_t seed)
+{
+  return uint8_t(i * 7 + seed);
+}
+
+static std::string body(uint32_t n, uint8_t seed)
+{
+  std::string b;
+  for (uint32_t i = 0; i < n; i++) b += char(bodyByte(i, seed));
+  return b;
+}
+
+// paths: /len/<n>/<seed>, /chunked/<n>/<seed>, /close/<n>/<seed>, /etag/<n>/<seed>, /nf, /odd
+static std::string serve(const std::string& request, bool& close)
+{
+  char kind[16] = "";
+  unsigned n = 0, seed = 0;
+  sscanf(request.c_str(), "GET /%15[a-z]/%u/%u", kind, &n, &seed);
+  std::string b = body(n, seed);
+  char head[160];
+  if (!strcmp(kind, "len"))
+  {
+    snprintf(head, sizeof(head), "HTTP/1.1 200 OK\r\ncontent-LENGTH: %u\r\nETag: \"v%u\"\r\n\r\n", n, seed);
+    return head + b;
+  }
+  if (!strcmp(kind, "chunked"))
+  {
+    std::string r = "HTTP/1.1 200 OK\r\nTransfer-Encoding: gzip, Chunked\r\n\r\n";
+    for (uint32_t i = 0, k = 1; i < n; k++)
+    {
+      uint32_t m = k * 97 % 3000 + 1;
+      if (m > n - i) m = n - i;
+      snprintf(head, sizeof(head), "%x;ext=1\r\n", m);
+      r += head + b.substr(i, m) + "\r\n";
+      i += m;
+    }
+    return r + "0\r\nX-Trailer: y\r\n\r\n";
+  }
+  if (!strcmp(kind, "close"))
+  {
+    close = true;
+    return "HTTP/1.0 200 OK\r\n\r\n" + b;
+  }
+  if (!strcmp(kind, "etag"))
+  {
+    snprintf(head, sizeof(head), "If-None-Match: \"v%u\"\r\n", seed);
+    if (request.find(head) != std::string::npos) return "HTTP/1.1 304 Not Modified\r\nETag: \"v" + std::to_string(seed) + "\"\r\n\r\n";
+    snprintf(head, sizeof(head), "HTTP/1.1 200 OK\r\nContent-Length: %u\r\nETag: \"v%u\"\r\n"
+             "Last-Modified: Mon, 19 Oct 2026 10:00:00 GMT\r\n\r\n", n, seed);
+    return head + b;
+  }
+  if (request.compare(0, 9, "GET /odd ") == 0)
+  {
+    // header names and values with bytes above 0x7F, a header line longer than the line buffer
+    return "HTTP/1.1 200 OK\r\nX-\xC4\xD6\xDC: \xE4\xF6\xFC\r\nX-Long: " + std::string(300, 'x') +
+           "\r\nConnection: Keep-Alive\r\nContent-Length: 3\r\n\r\nabc";
+  }
+  return "HTTP/1.1 404 Not Found\r\nContent-Length: 3\r\n\r\nno!";
+}
+
+// reads the body in varying sizes, returns the number of bytes that differ from body(n, seed)
+static uint32_t readBody(GxEPD2_32_HttpImageSource& source, uint8_t seed, uint32_t& n)
+{
+  uint8_t buffer[333];
+  uint32_t got, bad = 0;
+  n = 0;
+  while ((got = source.read(buffer, (n % 3) ? sizeof(buffer) : 7)) > 0)
+  {
+    for (uint32_t i = 0; i < got; i++) bad += (buffer[i] != bodyByte(n + i, seed));
+    n += got;
+  }
+  return bad;
+}
+
+int main()
+{
+  MockClient client(serve);
+  GxEPD2_32_HttpImageSource source(client);
+  uint32_t n;
+
+  // Content-Length, larger than the ring buffer; the connection is kept for the next get()
+  CHECK(source.connect("host.test", 80));
+  CHECK(source.get("/len/5000/1") == 200);
+  CHECK(source.contentLength() == 5000);
+  CHECK(!strcmp(source.etag(), "\"v1\""));
+  CHECK(readBody(source, 1, n) == 0);
+  CHECK(n == 5000);
+  CHECK(source.atEnd());
+  CHECK(source.bytesRead() == 5000);
+  CHECK(source.connect("host.test", 80));
+  CHECK(source.get("/len/0/0") == 200);
+  CHECK(source.atEnd());
+  CHECK(client.connects == 1);
+
+  // chunked, with extensions and a trailer, split at any byte; read16()/read32() across chunks
+  CHECK(source.get("/chunked/70000/2") == 200);
+  CHECK(source.contentLength() == -1);
+  CHECK(source.read16() == (bodyByte(0, 2) | (bodyByte(1, 2) << 8)));
+  CHECK(source.read32() == (bodyByte(2, 2) | (bodyByte(3, 2) << 8) | (uint32_t(bodyByte(4, 2)) << 16) | (uint32_t(bodyByte(5, 2)) << 24)));
+  CHECK(source.skip(1000) == 1000);
+  uint8_t buffer[64];
+  CHECK(source.read(buffer, 1) == 1);
+  CHECK(buffer[0] == bodyByte(1006, 2));
+  CHECK(source.skip(0xFFFFFFFF) == 70000 - 1007);
+  CHECK(source.atEnd());
+  CHECK(source.read() == -1);
+  CHECK(client.connects == 1);
+
+  // error status, the body is skipped and the connection kept
+  CHECK(source.get("/nf") == 404);
+  CHECK(source.skip(0xFFFFFFFF) == 3);
+  CHECK(source.atEnd());
+  CHECK(source.get("/chunked/10/3") == 200);
+  CHECK(readBody(source, 3, n) == 0);
+  CHECK(n == 10);
+  CHECK(client.connects == 1);
+
+  // the server has closed the kept connection: get() reconnects once and repeats the request
+  client.drop_requests = 1;
+  CHECK(source.get("/len/100/4") == 200);
+  CHECK(readBody(source, 4, n) == 0);
+  CHECK(n == 100);
+  CHECK(client.connects == 2);
+  CHECK(client.requests == 7);
+  // but not twice
+  client.drop_requests = 2;
+  CHECK(source.get("/len/100/4") == 0);
+  CHECK(client.connects == 3);
+
+  // HTTP/1.0 body until close, the next get() reconnects
+  CHECK(source.connect("host.test", 80));
+  CHECK(source.get("/close/4000/5") == 200);
+  CHECK(source.contentLength() == -1);
+  CHECK(readBody(source, 5, n) == 0);
+  CHECK(n == 4000);
+  CHECK(source.atEnd());
+  int connects = client.connects;
+  CHECK(source.get("/len/10/6") == 200);
+  CHECK(readBody(source, 6, n) == 0);
+  CHECK(client.connects == connects + 1);
+
+  // conditional request: 304 has no body, the connection is kept
+  CHECK(source.get("/etag/300/7") == 200);
+  CHECK(!strcmp(source.lastModified(), "Mon, 19 Oct 2026 10:00:00 GMT"));
+  CHECK(readBody(source, 7, n) == 0);
+  connects = client.connects;
+  CHECK(source.get("/etag/300/7", "If-None-Match: \"v7\"\r\n") == 304);
+  CHECK(source.atEnd());
+  CHECK(source.read(buffer, sizeof(buffer)) == 0);
+  CHECK(!strcmp(source.etag(), "\"v7\""));
+  CHECK(source.get("/len/20/8") == 200);
+  CHECK(readBody(source, 8, n) == 0);
+  CHECK(client.connects == connects);
+
+  // bytes above 0x7F in headers, long header lines
+  CHECK(source.get("/odd") == 200);
+  CHECK(source.contentLength() == 3);
+  CHECK(source.read(buffer, sizeof(buffer)) == 3);
+  CHECK(!memcmp(buffer, "abc", 3));
+
+  // a host name longer than max_host_length is refused, not cut
+  std::string host(GxEPD2_32_HttpImageSource::max_host_length + 1, 'h');
+  connects = client.connects;
+  CHECK(!source.connect(host.c_str(), 80));
+  CHECK(client.connects == connects);
+  CHECK(!strcmp(source.host(), "host.test"));
+  host.resize(GxEPD2_32_HttpImageSource::max_host_length);
+  CHECK(source.connect(host.c_str(), 80));
+  CHECK(!strcmp(source.host(), host.c_str()));
+  CHECK(source.get("/len/10/9") == 200);
+  CHECK(client.last_request.find("Host: " + host + "\r\n") != std::string::npos);
+
+  return hostTestResult("test_http");
+}
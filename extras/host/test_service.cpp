@@ -0,0 +1,257 @@
+// Host test of GxEPD2_32_Service with a recording display, see MockDisplay below:
+// producer threads against the owner task, no request lost, duplicated or reordered; bursts of a client merged
+// into the union of their regions; a full queue leads to a full refresh; min_interval_ms between refreshes.
+
+#include <GxEPD2_32_Service.h>
+#include "HostTest.h"
+#include <map>
+#include <thread>
+#include <vector>
+
+// the windows and refresh times of the picture loops of GxEPD2_32_Service::process(), pages_per_loop pages each
+class MockDisplay
+{
+  public:
+    struct Window
+    {
+      int16_t x, y, w, h;
+    };
+    static const uint8_t pages_per_loop = 2;
+    MockDisplay(bool partial_update = true) : full(false), _partial_update(partial_update), _page(0) {}
+    bool hasPartialUpdate()
+    {
+      return _partial_update;
+    }
+    void setFullWindow()
+    {
+      full = true;
+      windows.clear();
+    }
+    void setPartialWindow(int16_t x, int16_t y, int16_t w, int16_t h)
+    {
+      full = false;
+      windows.clear();
+      addPartialWindow(x, y, w, h);
+    }
+    void addPartialWindow(int16_t x, int16_t y, int16_t w, int16_t h)
+    {
+      Window window = {x, y, w, h};
+      windows.push_back(window);
+    }
+    void firstPage()
+    {
+      _page = 0;
+    }
+    bool nextPage()
+    {
+      if (++_page < pages_per_loop) return true;
+      refresh_ms.push_back(millis());
+      return false;
+    }
+    void fillScreen(uint16_t color)
+    {
+      (void) color;
+    }
+    bool full; // of the last picture loop
+    std::vector<Window> windows; // of the last picture loop, if not full
+    std::vector<unsigned long> refresh_ms;
+  private:
+    bool _partial_update;
+    uint8_t _page;
+};
+
+typedef GxEPD2_32_Service<MockDisplay> Service;
+typedef GxEPD2_32_Service<MockDisplay, 128> LargeService;
+
+static std::map<const void*, int> draws; // by pv, on the owner task
+static int other_draws = 0;
+
+static void drawClient(MockDisplay& display, const void* pv)
+{
+  (void) display;
+  draws[pv]++;
+}
+
+static void drawOther(MockDisplay& display, const void* pv)
+{
+  (void) display;
+  (void) pv;
+  other_draws++;
+}
+
+static bool windowIs(const MockDisplay::Window& window, int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  return (window.x == x) && (window.y == y) && (window.w == w) && (window.h == h);
+}
+
+// producer p requests x = k, w = 1 for k = 0 .. requests - 1, on row y = p; the windows of a producer are then
+// consecutive ranges of x: a lost request at the end of a burst leaves a gap, a repeated one an overlap
+static const uint8_t producers = 4;
+static const int16_t requests = 2000;
+static const uint8_t in_flight = 32; // per producer, producers * in_flight fit into the queue of LargeService
+static const uint32_t min_interval_ms = 2;
+static std::atomic<int> consumed[producers]; // x of the next window, from the windows of the owner task
+static std::atomic<int> refused(0);
+static std::atomic<bool> stopped(false); // by the owner task, on failure or timeout
+static const uint32_t timeout_ms = 10000;
+
+static void produce(LargeService* service, uint8_t p)
+{
+  for (int16_t k = 0; k < requests; k++)
+  {
+    while (k - consumed[p].load() >= in_flight)
+    {
+      if (stopped) return;
+      std::this_thread::yield();
+    }
+    if (!service->request(k, p, 1, 1, drawClient, &consumed[p])) refused++;
+  }
+}
+
+static void testProducers()
+{
+  MockDisplay display;
+  LargeService service(display, min_interval_ms);
+  std::vector<std::thread> threads;
+  int16_t next[producers];
+  uint32_t known[producers]; // refreshes before the first window of the producer
+  bool tiled = true, full = false;
+  uint32_t refreshes = 0;
+  unsigned long start = millis();
+  for (uint8_t p = 0; p < producers; p++)
+  {
+    consumed[p] = 0;
+    next[p] = 0;
+    known[p] = 0;
+  }
+  for (uint8_t p = 0; p < producers; p++) threads.push_back(std::thread(produce, &service, p));
+  for (;;)
+  {
+    bool done = true;
+    for (uint8_t p = 0; p < producers; p++) done = done && (next[p] == requests);
+    if (done || (millis() - start > timeout_ms)) break;
+    if (!service.process())
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    refreshes++;
+    full = full || display.full;
+    for (size_t i = 0; i < display.windows.size(); i++)
+    {
+      const MockDisplay::Window& window = display.windows[i];
+      uint8_t p = window.y;
+      tiled = tiled && (p < producers) && (window.x == next[p]) && (window.w > 0) && (window.h == 1);
+      if (!tiled) break;
+      if (next[p] == 0) known[p] = refreshes - 1;
+      next[p] = window.x + window.w;
+      consumed[p] = next[p];
+    }
+    if (!tiled || full) break;
+  }
+  stopped = true;
+  for (size_t i = 0; i < threads.size(); i++) threads[i].join();
+  for (uint8_t p = 0; p < producers; p++) CHECK(next[p] == requests);
+  CHECK(refused == 0);
+  CHECK(!full);
+  CHECK(tiled);
+  CHECK(!service.process());
+  CHECK(display.refresh_ms.size() == refreshes);
+  // bursts were merged, fewer refreshes than requests
+  CHECK(refreshes < uint32_t(producers) * requests);
+  bool spaced = true;
+  for (size_t i = 1; i < display.refresh_ms.size(); i++)
+  {
+    spaced = spaced && (display.refresh_ms[i] - display.refresh_ms[i - 1] >= min_interval_ms);
+  }
+  CHECK(spaced);
+  // every known client is drawn on every page
+  for (uint8_t p = 0; p < producers; p++) CHECK(draws[&consumed[p]] == int((refreshes - known[p]) * MockDisplay::pages_per_loop));
+}
+
+static void testMerge()
+{
+  MockDisplay display;
+  Service service(display);
+  int a, b;
+  draws.clear();
+  CHECK(!service.process());
+  CHECK(service.request(10, 10, 20, 20, drawClient, &a));
+  CHECK(service.request(50, 40, 10, 10, drawClient, &a));
+  CHECK(service.request(0, 0, 5, 5, drawClient, &b));
+  CHECK(service.request(-4, 0, 8, 8, drawOther, &a)); // another client, clipped
+  CHECK(service.request(0, 0, 0, 8, drawClient, &b)); // empty, ignored
+  CHECK(service.process());
+  CHECK(!display.full);
+  CHECK(display.windows.size() == 3);
+  CHECK((display.windows.size() == 3) && windowIs(display.windows[0], 10, 10, 50, 40));
+  CHECK((display.windows.size() == 3) && windowIs(display.windows[1], 0, 0, 5, 5));
+  CHECK((display.windows.size() == 3) && windowIs(display.windows[2], 0, 0, 4, 8));
+  CHECK(draws[&a] == MockDisplay::pages_per_loop);
+  CHECK(other_draws == MockDisplay::pages_per_loop);
+  CHECK(draws[&b] == MockDisplay::pages_per_loop);
+  CHECK(!service.pending());
+  CHECK(!service.process());
+  // after a refresh a request is no burst, its region replaces the last one
+  CHECK(service.request(100, 100, 8, 8, drawClient, &a));
+  CHECK(service.process());
+  CHECK((display.windows.size() == 1) && windowIs(display.windows[0], 100, 100, 8, 8));
+  // requestFull(), or no partial update: full refresh, drawn by all known clients
+  CHECK(service.request(0, 0, 8, 8, drawClient, &b));
+  CHECK(service.requestFull());
+  CHECK(service.process());
+  CHECK(display.full);
+  CHECK(display.refresh_ms.size() == 3);
+  MockDisplay full_display(false);
+  Service full_service(full_display);
+  CHECK(full_service.request(0, 0, 8, 8, drawClient, &a));
+  CHECK(full_service.process());
+  CHECK(full_display.full);
+}
+
+static void testOverflow()
+{
+  MockDisplay display;
+  GxEPD2_32_Service<MockDisplay, 4> service(display);
+  int a, b;
+  CHECK(service.request(0, 0, 8, 8, drawClient, &a));
+  CHECK(service.process());
+  for (int16_t k = 0; k < 4; k++) CHECK(service.request(k * 8, 0, 8, 8, drawClient, &a));
+  CHECK(!service.request(0, 16, 8, 8, drawClient, &a)); // full, dropped
+  draws.clear();
+  CHECK(service.process());
+  CHECK(display.full);
+  CHECK(draws[&a] == MockDisplay::pages_per_loop);
+  CHECK(!service.process());
+  // the queue is usable again, partial again
+  CHECK(service.request(0, 0, 8, 8, drawClient, &b));
+  CHECK(service.process());
+  CHECK(!display.full);
+  CHECK((display.windows.size() == 1) && windowIs(display.windows[0], 0, 0, 8, 8));
+}
+
+static void testMinInterval()
+{
+  const uint32_t interval = 30;
+  MockDisplay display;
+  Service service(display, interval);
+  int a;
+  CHECK(service.request(0, 0, 8, 8, drawClient, &a));
+  CHECK(service.process()); // the first refresh is not delayed
+  CHECK(service.request(8, 0, 8, 8, drawClient, &a));
+  CHECK(!service.process());
+  CHECK(service.pending());
+  while (!service.process()) std::this_thread::yield();
+  CHECK(display.refresh_ms.size() == 2);
+  CHECK((display.refresh_ms.size() == 2) && (display.refresh_ms[1] - display.refresh_ms[0] >= interval));
+  CHECK((display.windows.size() == 1) && windowIs(display.windows[0], 8, 0, 8, 8));
+}
+
+int main()
+{
+  testMerge();
+  testOverflow();
+  testMinInterval();
+  testProducers();
+  return hostTestResult("test_service");
+}
@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+# Replay a GxEPD2 command stream trace, as printed by trace().print(Serial), through a simple
+# timing model and report bus utilization, idle gaps and time per command.
+#
+# usage: trace_replay.py trace.txt [--spi-hz 4000000] [--gaps 10]
+#
+# Trace lines: kind start_us end_us wire_us length value(hex); kind C command, D data, B busy wait.
+
+import argparse
+import sys
+
+BUSY_PHASES = ['power on', 'update full', 'update part', 'power off', 'other']
+
+
+def read_trace(f):
+    entries = []
+    for line in f:
+        line = line.strip()
+        if not line or line.startswith('#'):
+            continue
+        parts = line.split()
+        if len(parts) != 6 or parts[0] not in 'CDB':
+            continue
+        kind, start, end, wire, length, value = parts
+        entries.append((kind, int(start), int(end), int(wire), int(length), int(value, 16)))
+    return entries
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('trace', nargs='?', type=argparse.FileType('r'), default=sys.stdin)
+    parser.add_argument('--spi-hz', type=int, default=4000000, help='SPI clock of the timing model')
+    parser.add_argument('--gaps', type=int, default=10, help='number of largest idle gaps to list')
+    args = parser.parse_args()
+
+    entries = read_trace(args.trace)
+    if not entries:
+        print('no trace entries')
+        return 1
+    span = entries[-1][2] - entries[0][1]
+    wire = sum(e[3] for e in entries)
+    busy = {}
+    for e in entries:
+        if e[0] == 'B':
+            name = BUSY_PHASES[e[5]] if e[5] < len(BUSY_PHASES) else str(e[5])
+            busy[name] = busy.get(name, 0) + e[2] - e[1]
+    busy_total = sum(busy.values())
+    byte_us = 8e6 / args.spi_hz
+    model = sum(e[4] * byte_us for e in entries if e[0] != 'B')
+
+    print('span            %10d us' % span)
+    print('on the wire     %10d us  %5.1f %%' % (wire, 100.0 * wire / max(span, 1)))
+    print('busy wait       %10d us  %5.1f %%' % (busy_total, 100.0 * busy_total / max(span, 1)))
+    for name, us in sorted(busy.items(), key=lambda kv: -kv[1]):
+        print('  %-13s %10d us' % (name, us))
+    idle = span - wire - busy_total
+    print('idle            %10d us  %5.1f %%' % (idle, 100.0 * idle / max(span, 1)))
+    print('model @ %d Hz: %d us of transfers, overhead %d us' % (args.spi_hz, model, wire - model))
+
+    # time and bytes per command, data is attributed to the command before it
+    per_command = {}
+    current = None
+    for e in entries:
+        if e[0] == 'C':
+            current = e[5]
+        if e[0] == 'B' or current is None:
+            continue
+        count, nbytes, us = per_command.get(current, (0, 0, 0))
+        per_command[current] = (count + (e[0] == 'C'), nbytes + (e[4] if e[0] == 'D' else 0), us + e[3])
+    print('\ncommand  count      bytes       wire us')
+    for c, (count, nbytes, us) in sorted(per_command.items(), key=lambda kv: -kv[1][2]):
+        print('  0x%02X %7d %10d %13d' % (c, count, nbytes, us))
+
+    # idle gaps: between entries, and inside coalesced data entries
+    gaps = []
+    for a, b in zip(entries, entries[1:]):
+        gaps.append((b[1] - a[2], 'after %s 0x%02X at %d us' % (a[0], a[5], a[2] - entries[0][1])))
+    for e in entries:
+        if e[0] == 'D' and e[2] - e[1] > e[3]:
+            gaps.append((e[2] - e[1] - e[3], 'within %d data bytes at %d us' % (e[4], e[1] - entries[0][1])))
+    gaps.sort(key=lambda g: -g[0])
+    print('\nlargest idle gaps')
+    for us, where in gaps[:args.gaps]:
+        print('  %10d us  %s' % (us, where))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())